@@ -0,0 +1,92 @@
+#include <functional>
+#include <iostream>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+#include "addressable_priority_queue.hpp"
+
+// Testing the data structure
+int main() {
+    addressable_priority_queue<int> pq;
+    auto ten = pq.push(10);
+    auto twenty = pq.push(20);
+    auto fifteen = pq.push(15);
+    pq.push(30);
+
+    std::cout << "Top element: " << pq.top() << std::endl; // 30
+
+    pq.increase_key(ten, 40);
+    std::cout << "Top element after raising 10 to 40: " << pq.top() << std::endl; // 40
+
+    pq.decrease_key(ten, 5);
+    std::cout << "Top element after lowering 40 to 5: " << pq.top() << std::endl; // 30
+
+    std::cout << "Erased element: " << pq.erase(twenty) << ", size now " << pq.size() << std::endl; // 20, 3
+
+    pq.update_priority(fifteen, 35);
+    std::cout << "Popping after updating 15 to 35: ";
+    while (!pq.empty()) {
+        std::cout << pq.top() << " ";
+        pq.pop();
+    }
+    std::cout << std::endl; // 35 30 5
+
+    try {
+        pq.value(ten);
+        std::cout << "Value of a popped handle. This line should never have been printed!" << std::endl;
+    } catch (const std::out_of_range& e) {
+        std::cout << "Exception correctly thrown for the handle of a popped element: " << e.what() << std::endl;
+    }
+
+    addressable_priority_queue<int, std::greater<int>, 4> min_pq;
+    auto handle = min_pq.push(7);
+    min_pq.push(3);
+    try {
+        min_pq.decrease_key(handle, 1);
+        std::cout << "Moved 7 towards the top with decrease_key. This line should never have been printed!" << std::endl;
+    } catch (const std::invalid_argument& e) {
+        std::cout << "Exception correctly thrown when decrease_key would raise priority: " << e.what() << std::endl;
+    }
+    min_pq.increase_key(handle, 1);
+    std::cout << "Top element in 4-ary min priority queue after lowering 7 to 1: " << min_pq.top() << std::endl; // 1
+
+    // Testing random pushes, pops, updates and erasures against a multiset
+    std::mt19937 random(1);
+    addressable_priority_queue<int, std::less<int>, 3> queue;
+    std::multiset<int> reference;
+    std::vector<addressable_priority_queue<int, std::less<int>, 3>::handle> handles;
+    bool same = true;
+    for (int step = 0; step < 200000; step++) {
+        int operation = random() % 4, value = random() % 1000;
+        if (operation == 0 || handles.empty()) {
+            handles.push_back(queue.push(value));
+            reference.insert(value);
+        } else if (operation == 1) {
+            reference.erase(reference.find(queue.top()));
+            queue.pop();
+        } else {
+            size_t k = random() % handles.size();
+            if (queue.contains(handles[k])) {
+                reference.erase(reference.find(queue.value(handles[k])));
+                if (operation == 2) {
+                    queue.update_priority(handles[k], value);
+                    reference.insert(value);
+                } else {
+                    queue.erase(handles[k]);
+                }
+            }
+            handles[k] = handles.back();
+            handles.pop_back();
+        }
+        if (queue.size() != reference.size() || (!queue.empty() && queue.top() != *reference.rbegin())) {
+            same = false;
+        }
+        if (queue.empty()) {
+            handles.clear();
+        }
+    }
+    std::cout << (same ? "same" : "different") << " tops as a multiset over 200000 random operations" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,246 @@
+#ifndef ADDRESSABLE_PRIORITY_QUEUE_HPP
+#define ADDRESSABLE_PRIORITY_QUEUE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Priority queue whose elements can be reprioritised or removed after they are pushed. push returns a handle
+// naming the element, and a position index maps every handle to the element's current slot in the d-ary heap,
+// updated on every move, so an element is found in O(1) and moved in O(log n) however it has been shifted.
+//
+// A handle stays valid until its element is popped or erased; after that it may be reused by a later push.
+// As with priority_queue, the top is the largest element by Compare, and "increase" and "decrease" follow
+// Compare too: increase_key moves an element towards the top. With std::greater (a min-queue, as shortest-path
+// searches use) lowering a distance is therefore increase_key.
+template<typename T, typename Compare = std::less<T>, size_t Arity = 2>
+class addressable_priority_queue {
+    static_assert(Arity >= 2, "a heap node needs at least two children");
+
+public:
+    using handle = size_t;
+
+private:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    struct Entry {
+        T value;
+        handle id;
+    };
+
+    std::vector<Entry> heap;
+    std::vector<size_t> position; // heap slot of every handle, npos if the handle is free
+    std::vector<handle> free_handles;
+    Compare comp;
+
+    // Move the entry into slot index and record where its handle now lives
+    void place(size_t index, Entry&& entry) {
+        position[entry.id] = index;
+        heap[index] = std::move(entry);
+    }
+
+    // Helper function to maintain the heap property: move the element at index up past smaller parents
+    void heapify_up(size_t index) {
+        Entry entry = std::move(heap[index]);
+        while (index > 0) {
+            size_t parent = (index - 1) / Arity;
+            if (!comp(heap[parent].value, entry.value)) {
+                break;
+            }
+            place(index, std::move(heap[parent]));
+            index = parent;
+        }
+        place(index, std::move(entry));
+    }
+
+    // Helper function to maintain the heap property: move the element at index down past larger children
+    void heapify_down(size_t index) {
+        size_t size = heap.size();
+        Entry entry = std::move(heap[index]);
+        while (true) {
+            size_t first_child = Arity * index + 1;
+            if (first_child >= size) {
+                break;
+            }
+
+            size_t largest = first_child, end = std::min(first_child + Arity, size);
+            for (size_t child = first_child + 1; child < end; child++) {
+                largest = comp(heap[largest].value, heap[child].value) ? child : largest;
+            }
+
+            if (!comp(entry.value, heap[largest].value)) {
+                break;
+            }
+            place(index, std::move(heap[largest]));
+            index = largest;
+        }
+        place(index, std::move(entry));
+    }
+
+    // Sift the element at index whichever way its value requires
+    void restore(size_t index) {
+        if (index > 0 && comp(heap[(index - 1) / Arity].value, heap[index].value)) {
+            heapify_up(index);
+        } else {
+            heapify_down(index);
+        }
+    }
+
+    // Take the element at index out of the heap, filling its slot with the last element, and free its handle
+    T remove_at(size_t index) {
+        handle id = heap[index].id;
+        T value = std::move(heap[index].value);
+        Entry last = std::move(heap.back());
+        heap.pop_back();
+        if (index < heap.size()) {
+            place(index, std::move(last));
+            restore(index);
+        }
+        position[id] = npos;
+        free_handles.push_back(id);
+        return value;
+    }
+
+    size_t slot_of(handle h) const {
+        if (!contains(h)) {
+            throw std::out_of_range("handle does not name an element of the addressable_priority_queue");
+        }
+
+        return position[h];
+    }
+
+public:
+    // Default constructor
+    addressable_priority_queue() = default;
+
+    explicit addressable_priority_queue(const Compare& compare) : comp(compare) {}
+
+    // Get the top element of the priority queue
+    const T& top() const {
+        if (heap.empty()) {
+            throw std::out_of_range("addressable_priority_queue is empty");
+        }
+
+        return heap.front().value;
+    }
+
+    // Get the handle of the top element
+    handle top_handle() const {
+        if (heap.empty()) {
+            throw std::out_of_range("addressable_priority_queue is empty");
+        }
+
+        return heap.front().id;
+    }
+
+    // Check if the priority queue is empty
+    bool empty() const {
+        return heap.empty();
+    }
+
+    // Get the size of the priority queue
+    size_t size() const {
+        return heap.size();
+    }
+
+    // Allocate room for `capacity` elements and handles up front
+    void reserve(size_t capacity) {
+        heap.reserve(capacity);
+        position.reserve(capacity);
+    }
+
+    // Check if a handle names an element currently in the queue
+    bool contains(handle h) const {
+        return h < position.size() && position[h] != npos;
+    }
+
+    // Get the element named by a handle
+    const T& value(handle h) const {
+        return heap[slot_of(h)].value;
+    }
+
+    // Push an element into the priority queue, returning its handle
+    handle push(T value) {
+        handle id;
+        if (free_handles.empty()) {
+            id = position.size();
+            position.push_back(npos);
+        } else {
+            id = free_handles.back();
+            free_handles.pop_back();
+        }
+
+        heap.push_back(Entry{ std::move(value), id }); // Add to the end of the heap
+        position[id] = heap.size() - 1;
+        heapify_up(heap.size() - 1); // Restore heap property
+        return id;
+    }
+
+    // Emplace an element into the priority queue, returning its handle
+    template<typename... Args>
+    handle emplace(Args&&... args) {
+        return push(T(std::forward<Args>(args)...));
+    }
+
+    // Pop the top element from the priority queue; its handle becomes invalid
+    void pop() {
+        if (heap.empty()) {
+            return;
+        }
+
+        remove_at(0);
+    }
+
+    // Replace the element named by h with a value of any priority
+    void update_priority(handle h, T value) {
+        size_t index = slot_of(h);
+        heap[index].value = std::move(value);
+        restore(index);
+    }
+
+    // Replace the element named by h with one that Compare ranks no lower, moving it towards the top
+    void increase_key(handle h, T value) {
+        size_t index = slot_of(h);
+        if (comp(value, heap[index].value)) {
+            throw std::invalid_argument("increase_key given a value of lower priority");
+        }
+
+        heap[index].value = std::move(value);
+        heapify_up(index);
+    }
+
+    // Replace the element named by h with one that Compare ranks no higher, moving it away from the top
+    void decrease_key(handle h, T value) {
+        size_t index = slot_of(h);
+        if (comp(heap[index].value, value)) {
+            throw std::invalid_argument("decrease_key given a value of higher priority");
+        }
+
+        heap[index].value = std::move(value);
+        heapify_down(index);
+    }
+
+    // Remove the element named by h, wherever it is in the heap, and return it; the handle becomes invalid
+    T erase(handle h) {
+        return remove_at(slot_of(h));
+    }
+
+    // Swap contents with another priority queue
+    void swap(addressable_priority_queue& other) {
+        std::swap(heap, other.heap);
+        std::swap(position, other.position);
+        std::swap(free_handles, other.free_handles);
+        std::swap(comp, other.comp);
+    }
+};
+
+// Non-member swap function
+template<typename T, typename Compare, size_t Arity>
+void swap(addressable_priority_queue<T, Compare, Arity>& lhs, addressable_priority_queue<T, Compare, Arity>& rhs) {
+    lhs.swap(rhs); // Forward to the member swap function
+}
+
+#endif
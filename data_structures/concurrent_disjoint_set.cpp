@@ -0,0 +1,93 @@
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "concurrent_disjoint_set.hpp"
+#include "disjoint_set.hpp"
+
+// Join `pairs` from `thread_count` threads, each taking an interleaved share, and return the seconds taken
+template<typename Join>
+double join_in_parallel(const std::vector<std::pair<uint32_t, uint32_t>>& pairs, unsigned thread_count, Join join) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < thread_count; t++) {
+        threads.emplace_back([&, t]() {
+            for (size_t k = t; k < pairs.size(); k += thread_count) join(pairs[k].first, pairs[k].second);
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    // Testing, single-threaded
+    ConcurrentDisjointSet disjoint_set(10);
+    disjoint_set.join(4, 3);
+    disjoint_set.join(3, 8);
+    disjoint_set.join(6, 5);
+    disjoint_set.join(9, 4);
+    disjoint_set.join(2, 1);
+    std::cout << disjoint_set.are_joint(0, 7) << std::endl; // false
+    std::cout << disjoint_set.are_joint(8, 9) << std::endl; // true
+    disjoint_set.join(5, 0);
+    disjoint_set.join(7, 2);
+    disjoint_set.join(6, 1);
+    disjoint_set.join(7, 3);
+    std::cout << disjoint_set.are_joint(7, 0) << std::endl; // true
+    std::cout << disjoint_set.join(8, 9) << std::endl; // false, already joint
+
+    // Testing, many threads joining random pairs while others query: the sets must come out the same as
+    // when the pairs are joined sequentially, and every joined pair must test as joint
+    const uint32_t n = 1 << 20;
+    const unsigned thread_count = 32;
+    std::mt19937 random(42);
+    std::vector<std::pair<uint32_t, uint32_t>> pairs(n * 3 / 4);
+    for (auto& [i, j] : pairs) i = random() % n, j = random() % n;
+
+    DisjointSet sequential(n);
+    auto start = std::chrono::steady_clock::now();
+    for (auto& [i, j] : pairs) sequential.join(i, j);
+    double sequential_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::mutex mutex;
+    DisjointSet locked(n);
+    double locked_seconds = join_in_parallel(pairs, thread_count, [&](uint32_t i, uint32_t j) {
+        std::lock_guard<std::mutex> lock(mutex);
+        locked.join(i, j);
+    });
+
+    for (auto linking : { ConcurrentDisjointSet::Linking::by_index, ConcurrentDisjointSet::Linking::by_random_priority }) {
+        ConcurrentDisjointSet concurrent(n, linking);
+        std::atomic<bool> done(false);
+        std::atomic<uint64_t> queries(0);
+        std::thread reader([&]() {
+            std::mt19937 query_random(7);
+            while (!done.load()) {
+                concurrent.are_joint(query_random() % n, query_random() % n);
+                queries++;
+            }
+        });
+        double concurrent_seconds = join_in_parallel(pairs, thread_count, [&](uint32_t i, uint32_t j) {
+            concurrent.join(i, j);
+        });
+        done = true;
+        reader.join();
+
+        uint32_t expected_sets = 0;
+        for (uint32_t i = 0; i < n; i++) expected_sets += sequential.find(i) == (int) i;
+        bool all_joint = true;
+        for (auto& [i, j] : pairs) all_joint &= concurrent.are_joint(i, j);
+        bool same_sets = concurrent.count_sets() == expected_sets;
+
+        std::cout << (linking == ConcurrentDisjointSet::Linking::by_index ? "Link by index: " : "Link by random priority: ")
+                  << (all_joint && same_sets ? "same sets as sequential joins" : "WRONG SETS") << ", "
+                  << concurrent_seconds << " s with " << thread_count << " threads (" << queries << " concurrent queries)"
+                  << std::endl;
+    }
+    std::cout << "Sequential DisjointSet: " << sequential_seconds << " s, behind one mutex: " << locked_seconds << " s" << std::endl;
+
+    return 0;
+}
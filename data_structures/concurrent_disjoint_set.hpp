@@ -0,0 +1,92 @@
+#ifndef CONCURRENT_DISJOINT_SET_HPP
+#define CONCURRENT_DISJOINT_SET_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Union-find that any number of threads can join and query at once, without locks (after Anderson and Woll,
+// and Jayanti and Tarjan). Every parent is an atomic word:
+//  - join links one root under another with a single compare-and-swap, retrying if the root was linked by
+//    another thread in the meantime. Roots are always linked under roots of higher priority, so no cycle can
+//    form and a root never becomes a root again.
+//  - find compresses by path halving, each step a compare-and-swap that simply gives up if another thread
+//    changed the parent first; compression only ever shortcuts to an ancestor, so it is safe to lose.
+//  - are_joint only finds and rereads one root, and returns after a bounded number of steps unless other
+//    threads keep linking the very roots it is looking at.
+// Priorities are the element indices (link by index) or a fixed pseudo-random permutation of them (link by
+// random priority), which keeps trees logarithmically shallow in expectation whatever order joins arrive in.
+class ConcurrentDisjointSet {
+public:
+    enum class Linking { by_index, by_random_priority };
+
+    ConcurrentDisjointSet(uint32_t n, Linking linking = Linking::by_random_priority) : root(n), linking(linking) {
+        for (uint32_t i = 0; i < n; i++) root[i].store(i, std::memory_order_relaxed);
+    }
+
+    // Root of i's set at some point during the call
+    uint32_t find(uint32_t i) {
+        while (true) {
+            uint32_t parent = root[i].load(std::memory_order_acquire);
+            if (parent == i) return i;
+            uint32_t grandparent = root[parent].load(std::memory_order_acquire);
+            if (parent == grandparent) return parent;
+
+            // path halving: point i at its grandparent unless another thread got there first
+            root[i].compare_exchange_weak(parent, grandparent, std::memory_order_release, std::memory_order_relaxed);
+            i = grandparent;
+        }
+    }
+
+    // Merge the sets of i and j; returns false if they were already the same set
+    bool join(uint32_t i, uint32_t j) {
+        while (true) {
+            uint32_t i_root = find(i), j_root = find(j);
+            if (i_root == j_root) return false;
+
+            // Always attach the root of lower priority, which fails if it stopped being a root meanwhile
+            if (higher_priority(i_root, j_root)) std::swap(i_root, j_root);
+            uint32_t expected = i_root;
+            if (root[i_root].compare_exchange_strong(expected, j_root, std::memory_order_seq_cst)) return true;
+        }
+    }
+
+    bool are_joint(uint32_t i, uint32_t j) {
+        while (true) {
+            uint32_t i_root = find(i), j_root = find(j);
+            if (i_root == j_root) return true;
+
+            // i_root was a root throughout, including when j_root was found to be one, so the sets were
+            // disjoint at that moment
+            if (root[i_root].load(std::memory_order_seq_cst) == i_root) return false;
+        }
+    }
+
+    // Number of sets; only meaningful while no thread is joining
+    uint32_t count_sets() const {
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < root.size(); i++) count += root[i].load(std::memory_order_relaxed) == i;
+        return count;
+    }
+
+private:
+    std::vector<std::atomic<uint32_t>> root;
+    Linking linking;
+
+    // Bijective mix of the index (a splitmix-style finaliser), so random priorities never tie
+    static uint32_t scramble(uint32_t i) {
+        i ^= i >> 16;
+        i *= 0x7feb352d;
+        i ^= i >> 15;
+        i *= 0x846ca68b;
+        i ^= i >> 16;
+        return i;
+    }
+
+    bool higher_priority(uint32_t i, uint32_t j) const {
+        return linking == Linking::by_index ? i > j : scramble(i) > scramble(j);
+    }
+};
+
+#endif
@@ -1,42 +1,9 @@
+#include <cstdint>
 #include <iostream>
+#include <random>
+#include <utility>
 #include <vector>
-
-class DisjointSet {
-private:
-    std::vector<int> root, child_count;
-
-    int get_root(int i) {
-        while (i != root[i]) {
-            root[i] = root[root[i]]; // path compression optimisation to shrink tree height
-            i = root[i];
-        }
-        return i;
-    }
-
-public:
-    DisjointSet(int n) {
-        root = child_count = std::vector<int>(n, 1);
-        for (int i = 0; i < n; i++) root[i] = i;
-    }
-
-    void join(int i, int j) {
-        int i_root = get_root(i), j_root = get_root(j);
-
-        // Always attach root of smaller tree to root of larger tree
-        // to keep the overall tree height as minimal as possible.
-        if (child_count[i_root] >= child_count[j_root]) {
-            root[j_root] = i_root;
-            child_count[i_root] += child_count[j_root];
-        } else {
-            root[i_root] = j_root;
-            child_count[j_root] += child_count[i_root];
-        }
-    }
-
-    bool are_joint(int i, int j) {
-        return get_root(i) == get_root(j);
-    }
-};
+#include "disjoint_set.hpp"
 
 int main() {
     // Testing
@@ -53,6 +20,34 @@ int main() {
     disjoint_set.join(6, 1);
     disjoint_set.join(7, 3);
     std::cout << disjoint_set.are_joint(7, 0) << std::endl; // true
+    std::cout << disjoint_set.join(8, 9) << std::endl; // false, already joint
+
+    // Testing the bulk API
+    for (int label : disjoint_set.component_labels()) std::cout << label << " ";
+    std::cout << std::endl; // 0 0 0 0 0 0 0 0 0 0
+    disjoint_set = DisjointSet(6);
+    disjoint_set.join_batch({ { 5, 1 }, { 2, 4 }, { 4, 5 } });
+    for (int label : disjoint_set.component_labels()) std::cout << label << " ";
+    std::cout << std::endl; // 0 1 1 2 1 1
+    for (size_t size : disjoint_set.component_sizes()) std::cout << size << " ";
+    std::cout << std::endl; // 1 4 1
+
+    // Testing a batch large enough to be split across threads (C++20 and later), with compact 32-bit indices,
+    // against pairs joined one at a time
+    const uint32_t n = 1 << 20;
+    std::mt19937 random(1);
+    std::vector<std::pair<uint32_t, uint32_t>> pairs(n);
+    for (auto& [i, j] : pairs) i = random() % n, j = random() % n;
+    BasicDisjointSet<uint32_t> batched(n), one_by_one(n);
+    size_t merged = batched.join_batch(pairs, 8);
+    for (auto& [i, j] : pairs) one_by_one.join(i, j);
+    std::cout << (batched.component_labels() == one_by_one.component_labels() ? "same" : "different")
+              << " sets, " << merged << " merging joins, " << batched.component_sizes().size() << " sets" << std::endl;
+#ifdef __cpp_lib_atomic_ref
+    std::cout << "batch joined on 8 threads" << std::endl;
+#else
+    std::cout << "batch joined on one thread: a parallel join_batch needs C++20 (std::atomic_ref)" << std::endl;
+#endif
 
     return 0;
 }
@@ -0,0 +1,142 @@
+#ifndef DISJOINT_SET_HPP
+#define DISJOINT_SET_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Union-find over elements 0 .. n - 1 using Rem's algorithm: trees are linked by index, every parent having a
+// lower index than its children, and each join walks both paths at once, splicing them towards lower indices
+// as it goes. Index is the element type: int by default, uint32_t to halve the memory of large sets, or a
+// 64-bit type for more than 2^32 elements.
+template<typename Index = int>
+class BasicDisjointSet {
+private:
+    std::vector<Index> root;
+
+    Index get_root(Index i) {
+        while (i != root[i]) {
+            root[i] = root[root[i]]; // path compression optimisation to shrink tree height
+            i = root[i];
+        }
+        return i;
+    }
+
+#ifdef __cpp_lib_atomic_ref
+    // Root of i, halving the path with compare-and-swaps that give up if another thread got there first
+    Index get_root_concurrently(Index i) {
+        while (true) {
+            Index parent = std::atomic_ref<Index>(root[i]).load(std::memory_order_acquire);
+            if (parent == i) return i;
+            Index grandparent = std::atomic_ref<Index>(root[parent]).load(std::memory_order_acquire);
+            if (parent == grandparent) return parent;
+            std::atomic_ref<Index>(root[i]).compare_exchange_weak(parent, grandparent, std::memory_order_release,
+                                                                  std::memory_order_relaxed);
+            i = grandparent;
+        }
+    }
+
+    // Lock-free join for join_batch: link the higher root under the lower one, retrying if it stopped being a
+    // root meanwhile. Linking by index keeps the parent-below-child order Rem's algorithm relies on.
+    bool join_concurrently(Index i, Index j) {
+        while (true) {
+            Index i_root = get_root_concurrently(i), j_root = get_root_concurrently(j);
+            if (i_root == j_root) return false;
+            if (i_root < j_root) std::swap(i_root, j_root);
+            Index expected = i_root;
+            if (std::atomic_ref<Index>(root[i_root]).compare_exchange_strong(expected, j_root)) return true;
+        }
+    }
+#endif
+
+public:
+    BasicDisjointSet(Index n) : root(n) {
+        for (Index i = 0; i < n; i++) root[i] = i;
+    }
+
+    // Merge the sets of i and j; returns false if they were already the same set
+    bool join(Index i, Index j) {
+        // Walk up from whichever side has the higher parent. On reaching a root, hang it under the other
+        // side's parent; otherwise splice the node onto the other side's (lower) parent before moving up.
+        while (root[i] != root[j]) {
+            if (root[i] < root[j]) std::swap(i, j);
+            if (i == root[i]) {
+                root[i] = root[j];
+                return true;
+            }
+            Index next = root[i];
+            root[i] = root[j];
+            i = next;
+        }
+        return false;
+    }
+
+    // Join every pair, splitting the batch into one contiguous shard per thread; returns how many joins
+    // merged two sets. Without std::atomic_ref (before C++20) the pairs are joined one by one.
+    size_t join_batch(const std::vector<std::pair<Index, Index>>& pairs,
+                      unsigned thread_count = std::thread::hardware_concurrency()) {
+        size_t merged = 0;
+#ifdef __cpp_lib_atomic_ref
+        if (thread_count > 1 && pairs.size() >= (1 << 14)) {
+            std::atomic<size_t> total(0);
+            std::vector<std::thread> threads;
+            for (unsigned t = 0; t < thread_count; t++) {
+                threads.emplace_back([&, t]() {
+                    size_t begin = pairs.size() * t / thread_count, end = pairs.size() * (t + 1) / thread_count;
+                    size_t local = 0;
+                    for (size_t k = begin; k < end; k++) local += join_concurrently(pairs[k].first, pairs[k].second);
+                    total += local;
+                });
+            }
+            for (std::thread& thread : threads) thread.join();
+            return total;
+        }
+#else
+        (void) thread_count;
+#endif
+        for (const auto& [i, j] : pairs) merged += join(i, j);
+        return merged;
+    }
+
+    bool are_joint(Index i, Index j) {
+        return get_root(i) == get_root(j);
+    }
+
+    // Root of i without compressing the path. Never writes, so any number of threads may call it while no
+    // thread joins.
+    Index find(Index i) const {
+        while (i != root[i]) i = root[i];
+        return i;
+    }
+
+    // Point every element straight at its root. Parents have lower indices, so one ascending pass finds each
+    // parent already flattened.
+    void flatten() {
+        for (size_t i = 0; i < root.size(); i++) root[i] = root[root[i]];
+    }
+
+    // Dense set IDs 0 .. sets - 1, numbered in order of each set's lowest element; flattens the forest
+    std::vector<Index> component_labels() {
+        flatten();
+        std::vector<Index> labels(root.size());
+        Index next_label = 0;
+        for (size_t i = 0; i < root.size(); i++) labels[i] = (Index) i == root[i] ? next_label++ : labels[root[i]];
+        return labels;
+    }
+
+    // Size of every set, indexed by the labels of component_labels
+    std::vector<size_t> component_sizes() {
+        std::vector<size_t> sizes;
+        for (Index label : component_labels()) {
+            if ((size_t) label == sizes.size()) sizes.push_back(0);
+            sizes[label]++;
+        }
+        return sizes;
+    }
+};
+
+using DisjointSet = BasicDisjointSet<>;
+
+#endif
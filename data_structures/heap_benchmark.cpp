@@ -0,0 +1,148 @@
+// Compare the heap policies of heap_policies.hpp, and std::priority_queue, on two min-queue workloads:
+//   events   a discrete event simulation: `n` pending events (default 1 << 20, or the first argument), and n
+//            times the earliest is popped and a later event scheduled in its place
+//   sssp     Dijkstra's algorithm on a random graph of n / 4 vertices and 8 edges per vertex with weights up to
+//            1000, pushing a duplicate entry on every improvement and skipping stale ones (lazy deletion); the
+//            pairing heap runs it a second time updating each vertex's entry with increase_key instead
+// Every row reports seconds, the peak number of queued entries and a checksum of the results, which must agree
+// between implementations.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include "heap_policies.hpp"
+
+using Entry = std::pair<uint32_t, uint32_t>; // (distance, vertex)
+
+struct Graph {
+    std::vector<uint32_t> offsets, targets, weights;
+};
+
+struct StdPolicy {
+    template<typename T, typename Compare>
+    using queue = std::priority_queue<T, std::vector<T>, Compare>;
+};
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename Policy>
+void events(const char* name, size_t n) {
+    std::mt19937_64 random(1);
+    heap<uint64_t, std::greater<uint64_t>, Policy> q;
+    for (size_t i = 0; i < n; i++) q.push(random() % (1 << 20));
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t now = q.top();
+        q.pop();
+        checksum += now;
+        q.push(now + 1 + random() % 1000);
+    }
+    printf("%-10s %-24s %10.3f %12zu   %016llx\n", "events", name, seconds_since(start), n,
+           (unsigned long long) checksum);
+}
+
+uint64_t checksum_of(const std::vector<uint32_t>& distance) {
+    uint64_t checksum = 0;
+    for (uint32_t d : distance) checksum = checksum * 31 + d;
+    return checksum;
+}
+
+template<typename Policy>
+void sssp(const char* name, const Graph& graph) {
+    size_t n = graph.offsets.size() - 1, peak = 0;
+    std::vector<uint32_t> distance(n, std::numeric_limits<uint32_t>::max());
+    heap<Entry, std::greater<Entry>, Policy> q;
+
+    auto start = std::chrono::steady_clock::now();
+    distance[0] = 0;
+    q.push(Entry(0, 0));
+    while (!q.empty()) {
+        auto [d, u] = q.top();
+        q.pop();
+        if (d > distance[u]) continue; // stale entry
+        for (uint32_t e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+            uint32_t v = graph.targets[e], candidate = d + graph.weights[e];
+            if (candidate < distance[v]) {
+                distance[v] = candidate;
+                q.push(Entry(candidate, v));
+                peak = std::max(peak, q.size());
+            }
+        }
+    }
+    printf("%-10s %-24s %10.3f %12zu   %016llx\n", "sssp", name, seconds_since(start), peak,
+           (unsigned long long) checksum_of(distance));
+}
+
+// Dijkstra's algorithm keeping at most one entry per vertex, moved up with increase_key on every improvement
+void sssp_increase_key(const Graph& graph) {
+    size_t n = graph.offsets.size() - 1, peak = 0;
+    std::vector<uint32_t> distance(n, std::numeric_limits<uint32_t>::max());
+    std::vector<pairing_heap<Entry, std::greater<Entry>>::handle> handles(n, nullptr);
+    std::vector<bool> done(n, false);
+    pairing_heap<Entry, std::greater<Entry>> q;
+
+    auto start = std::chrono::steady_clock::now();
+    distance[0] = 0;
+    handles[0] = q.push(Entry(0, 0));
+    while (!q.empty()) {
+        uint32_t u = q.top().second;
+        q.pop();
+        done[u] = true;
+        for (uint32_t e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+            uint32_t v = graph.targets[e], candidate = distance[u] + graph.weights[e];
+            if (!done[v] && candidate < distance[v]) {
+                if (distance[v] == std::numeric_limits<uint32_t>::max()) {
+                    handles[v] = q.push(Entry(candidate, v));
+                    peak = std::max(peak, q.size());
+                } else {
+                    q.increase_key(handles[v], Entry(candidate, v));
+                }
+                distance[v] = candidate;
+            }
+        }
+    }
+    printf("%-10s %-24s %10.3f %12zu   %016llx\n", "sssp", "pairing, increase_key", seconds_since(start), peak,
+           (unsigned long long) checksum_of(distance));
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1 << 20;
+
+    printf("%-10s %-24s %10s %12s   %s\n", "workload", "heap", "seconds", "peak size", "checksum");
+    events<StdPolicy>("std::priority_queue", n);
+    events<d_ary_heap_policy<2>>("binary heap", n);
+    events<d_ary_heap_policy<4>>("4-ary heap", n);
+    events<pairing_heap_policy>("pairing heap", n);
+    events<radix_heap_policy>("radix heap", n);
+
+    Graph graph;
+    size_t vertices = std::max<size_t>(n / 4, 1), degree = 8;
+    std::mt19937 random(2);
+    for (size_t u = 0; u < vertices; u++) {
+        graph.offsets.push_back(graph.targets.size());
+        for (size_t k = 0; k < degree; k++) {
+            graph.targets.push_back(random() % vertices);
+            graph.weights.push_back(1 + random() % 1000);
+        }
+    }
+    graph.offsets.push_back(graph.targets.size());
+
+    sssp<StdPolicy>("std::priority_queue", graph);
+    sssp<d_ary_heap_policy<2>>("binary heap", graph);
+    sssp<d_ary_heap_policy<4>>("4-ary heap", graph);
+    sssp<pairing_heap_policy>("pairing heap", graph);
+    sssp<radix_heap_policy>("radix heap", graph);
+    sssp_increase_key(graph);
+    return 0;
+}
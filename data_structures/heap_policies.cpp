@@ -0,0 +1,73 @@
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "heap_policies.hpp"
+
+// The same min-queue workload on any policy: pops interleaved with pushes of keys no smaller than the last pop,
+// which every policy (the monotone radix heap included) accepts. Returns whether the pops matched
+// std::priority_queue's.
+template<typename Policy>
+bool same_pops_as_std(unsigned seed) {
+    using Entry = std::pair<uint32_t, uint32_t>;
+    heap<Entry, std::greater<Entry>, Policy> q;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> reference;
+    std::mt19937 random(seed);
+    uint32_t last = 0;
+    for (int step = 0; step < 100000; step++) {
+        if (random() % 3 != 0 || q.empty()) {
+            Entry entry(last + random() % 1000, step);
+            q.push(entry);
+            reference.push(entry);
+        } else {
+            // Radix heaps pop equal keys in any order, so compare keys only
+            if (q.top().first != reference.top().first || q.size() != reference.size()) return false;
+            last = q.top().first;
+            q.pop();
+            reference.pop();
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "4-ary heap: " << (same_pops_as_std<d_ary_heap_policy<4>>(1) ? "same" : "different") << " pops as std::priority_queue" << std::endl;
+    std::cout << "Pairing heap: " << (same_pops_as_std<pairing_heap_policy>(2) ? "same" : "different") << " pops as std::priority_queue" << std::endl;
+    std::cout << "Radix heap: " << (same_pops_as_std<radix_heap_policy>(3) ? "same" : "different") << " pops as std::priority_queue" << std::endl;
+
+    // Testing the pairing heap's meld and increase_key
+    heap<int, std::greater<int>, pairing_heap_policy> first, second;
+    first.push(10);
+    auto thirty = first.push(30);
+    second.push(20);
+    auto forty = second.push(40);
+    first.meld(second);
+    std::cout << "Size after meld: " << first.size() << ", size of the melded heap: " << second.size() << std::endl; // 4, 0
+    first.increase_key(forty, 5);
+    first.increase_key(thirty, 1);
+    std::cout << "Popping after lowering 40 to 5 and 30 to 1: ";
+    while (!first.empty()) {
+        std::cout << first.top() << " ";
+        first.pop();
+    }
+    std::cout << std::endl; // 1 5 10 20
+
+    // Testing the radix heap's monotone key check
+    heap<uint64_t, std::greater<uint64_t>, radix_heap_policy> radix;
+    radix.push(7);
+    radix.push(3);
+    std::cout << "Radix heap top: " << radix.top() << std::endl; // 3
+    radix.pop();
+    try {
+        radix.push(2);
+        std::cout << "Pushed 2 after popping 3. This line should never have been printed!" << std::endl;
+    } catch (const std::invalid_argument& e) {
+        std::cout << "Exception correctly thrown when pushing below the minimum: " << e.what() << std::endl;
+    }
+
+    return 0;
+}
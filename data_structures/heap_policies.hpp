@@ -0,0 +1,36 @@
+#ifndef HEAP_POLICIES_HPP
+#define HEAP_POLICIES_HPP
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "pairing_heap.hpp"
+#include "priority_queue.hpp"
+#include "radix_heap.hpp"
+
+// Policies choosing a heap implementation. Every one provides top, push, emplace, pop, swap, empty and size,
+// so code written against heap<T, Compare, Policy> switches implementation by changing only the policy:
+//  - d_ary_heap_policy<Arity>: the array-based priority_queue, the best general-purpose choice
+//  - pairing_heap_policy: node-based, with O(1) meld and increase_key through the handles push returns
+//  - radix_heap_policy: unsigned integer keys pushed in monotone order (no key below the current minimum),
+//    popped without comparing elements; a min-queue, so Compare must be std::greater<T>
+template<size_t Arity = 2>
+struct d_ary_heap_policy {
+    template<typename T, typename Compare>
+    using queue = priority_queue<T, std::vector<T>, Compare, Arity>;
+};
+
+struct pairing_heap_policy {
+    template<typename T, typename Compare>
+    using queue = pairing_heap<T, Compare>;
+};
+
+struct radix_heap_policy {
+    template<typename T, typename Compare>
+    using queue = radix_heap<T, Compare>;
+};
+
+template<typename T, typename Compare = std::less<T>, typename Policy = d_ary_heap_policy<>>
+using heap = typename Policy::template queue<T, Compare>;
+
+#endif
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include "mpmc_queue.hpp"
+
+int main() {
+    // Testing, single-threaded
+    mpmc_queue<int> q(3);
+    std::cout << "Capacity rounded up from 3: " << q.capacity() << std::endl; // 4
+    for (int i = 1; i <= 4; i++) q.enqueue(i);
+    std::cout << "Enqueue into full queue: " << (q.try_enqueue(5) ? "succeeded" : "failed") << std::endl; // failed
+    std::cout << q.dequeue() << " " << q.dequeue() << std::endl; // 1 2
+    q.enqueue(5);
+    q.enqueue(6);
+    int value;
+    while (q.try_dequeue(value)) std::cout << value << " ";
+    std::cout << std::endl; // 3 4 5 6
+
+#ifdef __cpp_lib_atomic_wait
+    std::cout << "Idle consumers sleep on a futex" << std::endl;
+#else
+    std::cout << "Idle consumers yield instead of sleeping: Idle::sleep needs C++20 (std::atomic::wait)" << std::endl;
+#endif
+
+    // Testing, many producers and consumers, with consumers sleeping when idle: every item must be received
+    // exactly once, and each producer's items in the order it sent them
+    const unsigned producers = 8, consumers = 8;
+    const uint32_t per_producer = 1 << 17;
+    mpmc_queue<uint64_t> shared(256, mpmc_queue<uint64_t>::Idle::sleep);
+    std::vector<std::vector<uint64_t>> received(consumers);
+    std::vector<std::thread> threads;
+    for (unsigned p = 0; p < producers; p++) {
+        threads.emplace_back([&, p]() {
+            for (uint32_t i = 0; i < per_producer; i++) shared.enqueue((uint64_t) p << 32 | i);
+        });
+    }
+    for (unsigned c = 0; c < consumers; c++) {
+        threads.emplace_back([&, c]() {
+            for (uint32_t i = 0; i < producers * per_producer / consumers; i++) received[c].push_back(shared.dequeue());
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    bool in_order = true;
+    std::vector<uint64_t> all;
+    for (auto& items : received) {
+        std::vector<int64_t> last(producers, -1);
+        for (uint64_t item : items) {
+            in_order &= (int64_t) (item & 0xffffffff) > last[item >> 32];
+            last[item >> 32] = item & 0xffffffff;
+        }
+        all.insert(all.end(), items.begin(), items.end());
+    }
+    std::sort(all.begin(), all.end());
+    bool exactly_once = all.size() == (size_t) producers * per_producer;
+    for (size_t i = 0; exactly_once && i < all.size(); i++) {
+        exactly_once = all[i] == ((uint64_t) (i / per_producer) << 32 | i % per_producer);
+    }
+    std::cout << (exactly_once ? "every item received exactly once" : "ITEMS LOST OR DUPLICATED") << ", "
+              << (in_order ? "in order" : "OUT OF ORDER") << " per producer, " << shared.size() << " left" << std::endl;
+
+    // Testing, one slow producer sending bursts with pauses between them, so the consumers keep going to sleep
+    // and being woken while the queue is nearly empty: every item must still be received
+    const unsigned sleepers = 4;
+    const uint32_t bursts = 200, per_burst = 10;
+    mpmc_queue<uint32_t> sparse(64, mpmc_queue<uint32_t>::Idle::sleep);
+    std::vector<uint64_t> sums(sleepers, 0);
+    threads.clear();
+    for (unsigned c = 0; c < sleepers; c++) {
+        threads.emplace_back([&, c]() {
+            for (uint32_t i = 0; i < bursts * per_burst / sleepers; i++) sums[c] += sparse.dequeue();
+        });
+    }
+    threads.emplace_back([&]() {
+        for (uint32_t i = 0; i < bursts * per_burst; i++) {
+            sparse.enqueue(i);
+            if (i % per_burst == per_burst - 1) std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+    for (std::thread& thread : threads) thread.join();
+    uint64_t sum = 0, count = bursts * per_burst;
+    for (uint64_t s : sums) sum += s;
+    std::cout << (sum == count * (count - 1) / 2 ? "every" : "NOT every") << " item of " << bursts
+              << " bursts received by sleeping consumers" << std::endl;
+
+    // Testing, sleeping consumers woken over and over: producers send single items with random pauses that keep
+    // the consumers on the edge between finding an item and going to sleep, so that wake-ups often race with
+    // consumers that find an item on their own. A lost wake-up leaves items queued with every consumer asleep;
+    // the watchdog reports that instead of hanging.
+    const unsigned racing_producers = 2, racing_consumers = 3;
+    const uint32_t per_racing_producer = 20000;
+    mpmc_queue<uint32_t> racing(8, mpmc_queue<uint32_t>::Idle::sleep);
+    std::atomic<uint32_t> taken{ 0 };
+    threads.clear();
+    for (unsigned c = 0; c < racing_consumers; c++) {
+        threads.emplace_back([&]() {
+            while (racing.dequeue() != UINT32_MAX) taken.fetch_add(1);
+        });
+    }
+    for (unsigned p = 0; p < racing_producers; p++) {
+        threads.emplace_back([&, p]() {
+            std::mt19937 random(p);
+            for (uint32_t i = 0; i < per_racing_producer; i++) {
+                racing.enqueue(i);
+                uint32_t pause = random() % 64;
+                if (pause < 32) {
+                    continue;
+                } else if (pause < 60) {
+                    std::this_thread::yield();
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(pause));
+                }
+            }
+        });
+    }
+    uint32_t last_taken = 0;
+    for (int idle_checks = 0; taken.load() < racing_producers * per_racing_producer;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        idle_checks = taken.load() == last_taken && !racing.is_empty() ? idle_checks + 1 : 0;
+        last_taken = taken.load();
+        if (idle_checks == 50) {
+            std::cout << "CONSUMERS STUCK with " << racing.size() << " items queued" << std::endl;
+            std::_Exit(1);
+        }
+    }
+    for (unsigned c = 0; c < racing_consumers; c++) racing.enqueue(UINT32_MAX);
+    for (std::thread& thread : threads) thread.join();
+    std::cout << taken.load() << " items received by consumers racing their wake-ups" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,194 @@
+#ifndef MPMC_QUEUE_HPP
+#define MPMC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+// Bounded queue for any number of producer and consumer threads (Dmitry Vyukov's design). Every slot of the
+// power-of-two ring carries a sequence number saying whose turn it is:
+//  - a slot whose sequence equals position p is free for the producer claiming p, which takes the position
+//    with a compare-and-swap on tail, writes the payload and publishes it by storing sequence p + 1;
+//  - a slot whose sequence is p + 1 holds the item for the consumer claiming p, which takes the position with a
+//    compare-and-swap on head, reads the payload and frees the slot for the next lap by storing p + capacity.
+// Producers and consumers therefore only contend on their own index and never on each other's, and a thread
+// preempted mid-operation holds up only the one slot it claimed.
+//
+// try_enqueue and try_dequeue never block. enqueue and dequeue wait while the queue is full or empty: they
+// spin, then yield, and with Idle::sleep an idle consumer instead sleeps on a futex (std::atomic::wait, C++20)
+// until a producer wakes it. Sleeping saves the CPU time idle consumers would burn, at the price of a fence
+// and a load in every enqueue.
+//
+// Idle::sleep needs C++20. Compiled as an earlier standard, which lacks std::atomic::wait, it behaves like
+// Idle::spin: idle consumers keep yielding.
+template<typename T>
+class mpmc_queue {
+public:
+    enum class Idle { spin, sleep };
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct alignas(CACHE_LINE) Slot {
+        std::atomic<size_t> sequence;
+        T payload;
+    };
+
+    size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    Idle idle;
+
+    alignas(CACHE_LINE) std::atomic<size_t> tail{ 0 }; // next position to enqueue
+    alignas(CACHE_LINE) std::atomic<size_t> head{ 0 }; // next position to dequeue
+    alignas(CACHE_LINE) std::atomic<uint32_t> wakeups{ 0 }; // bumped to wake sleeping consumers
+    std::atomic<uint32_t> sleeping{ 0 }; // consumers registered to sleep
+    std::atomic<uint64_t> sleeps{ 0 }; // registrations so far, numbering the sleepers' epochs from 1
+    std::atomic<uint64_t> woken_epoch{ 0 }; // epoch a consumer was last woken for; 0 once a woken one left
+
+    static size_t round_up_to_power_of_two(size_t n) {
+        size_t power = 2;
+        while (power < n) power *= 2;
+        return power;
+    }
+
+    // Wake a consumer if any may be sleeping and none has been woken since the last one went to sleep. The
+    // fence orders the slot just published before the reads of `sleeping` and `sleeps`, pairing with the
+    // fence in dequeue, so either the consumer sees the item or this sees the consumer and its epoch.
+    //
+    // The gate is per epoch rather than a flag a consumer clears: a wake-up issued for an epoch reaches one of
+    // the consumers asleep by then, and any consumer registering later starts a new epoch that opens the gate
+    // again. A producer that is slow to set the gate only sets it for an epoch that is already over, which
+    // costs an extra wake-up at worst, never a lost one.
+    void wake_consumer() {
+#ifdef __cpp_lib_atomic_wait
+        if (idle == Idle::sleep) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleeping.load() > 0) {
+                uint64_t epoch = sleeps.load();
+                if (woken_epoch.exchange(epoch) != epoch) {
+                    wakeups.fetch_add(1);
+                    wakeups.notify_one();
+                }
+            }
+        }
+#endif
+    }
+
+public:
+    // Room for at least `capacity` items, rounded up to a power of two
+    explicit mpmc_queue(size_t capacity, Idle idle = Idle::spin)
+        : mask(round_up_to_power_of_two(capacity) - 1), slots(new Slot[mask + 1]), idle(idle) {
+        for (size_t i = 0; i <= mask; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    // Add an item, returning false if the queue is full
+    bool try_enqueue(T payload) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[position & mask];
+            intptr_t lap = (intptr_t) slot->sequence.load(std::memory_order_acquire) - (intptr_t) position;
+            if (lap == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            } else if (lap < 0) {
+                return false; // the slot still holds the item from the previous lap
+            } else {
+                position = tail.load(std::memory_order_relaxed); // another producer took the position
+            }
+        }
+
+        slot->payload = std::move(payload);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        wake_consumer();
+        return true;
+    }
+
+    // Remove the oldest available item into payload, returning false if the queue is empty
+    bool try_dequeue(T& payload) {
+        size_t position = head.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[position & mask];
+            intptr_t lap = (intptr_t) slot->sequence.load(std::memory_order_acquire) - (intptr_t) (position + 1);
+            if (lap == 0) {
+                if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            } else if (lap < 0) {
+                return false; // the slot's item has not been published yet
+            } else {
+                position = head.load(std::memory_order_relaxed); // another consumer took the position
+            }
+        }
+
+        payload = std::move(slot->payload);
+        slot->sequence.store(position + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Add an item, waiting while the queue is full
+    void enqueue(T payload) {
+        for (int spins = 0; !try_enqueue(payload); spins++) {
+            if (spins >= 64) std::this_thread::yield();
+        }
+    }
+
+    // Remove the oldest available item, waiting while the queue is empty: spinning, then yielding, and only
+    // then (with Idle::sleep) sleeping. Producers wake one sleeper per epoch, so a woken consumer reopens the
+    // gate when it leaves and passes the wake-up on if items remain.
+    T dequeue() {
+        T payload;
+        [[maybe_unused]] bool woken = false; // unused without std::atomic::wait
+        for (int spins = 0; !try_dequeue(payload); spins++) {
+            if (spins < 64) continue;
+#ifdef __cpp_lib_atomic_wait
+            if (idle == Idle::sleep && spins >= 64 + 16) {
+                // Register as sleeping, then look once more: a producer either sees the registration or
+                // published its item before the second look
+                uint32_t seen = wakeups.load();
+                sleeps.fetch_add(1); // before `sleeping`, so a producer that counts this sleeper sees its epoch
+                sleeping.fetch_add(1);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                bool found = try_dequeue(payload);
+                if (!found) wakeups.wait(seen);
+                sleeping.fetch_sub(1);
+                if (found) break;
+                woken = true;
+                continue;
+            }
+#endif
+            std::this_thread::yield();
+        }
+#ifdef __cpp_lib_atomic_wait
+        if (woken) {
+            // Reopen the gate before looking at the queue, pairing with the fence in wake_consumer: an item this
+            // consumer does not see was published by a producer that will find the gate open
+            woken_epoch.store(0);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!is_empty()) wake_consumer();
+        }
+#endif
+        return payload;
+    }
+
+    // Number of items queued (including claimed slots not yet written or read); exact while no thread is
+    // mid-operation
+    size_t size() const {
+        size_t h = head.load(std::memory_order_acquire);
+        size_t t = tail.load(std::memory_order_acquire);
+        return t > h ? t - h : 0;
+    }
+
+    bool is_empty() const {
+        return size() == 0;
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+};
+
+#endif
@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "multi_queue.hpp"
+
+int main() {
+    // Testing, single-threaded: pops come out near, but not necessarily exactly in, priority order
+    MultiQueue<int, std::greater<int>> multi_queue(1);
+    for (int value : { 10, 20, 15, 30, 5 }) multi_queue.push(value);
+    std::cout << "Size of the multi-queue: " << multi_queue.size() << std::endl; // 5
+    std::vector<int> popped;
+    int value;
+    while (multi_queue.try_pop(value)) popped.push_back(value);
+    std::sort(popped.begin(), popped.end());
+    for (int value : popped) std::cout << value << " ";
+    std::cout << std::endl; // 5 10 15 20 30
+    std::cout << "Pop from empty multi-queue: " << (multi_queue.try_pop(value) ? "succeeded" : "failed") << std::endl;
+
+    // Testing, many threads pushing and popping at once: every pushed element must be popped exactly once
+    const unsigned thread_count = 16;
+    const int per_thread = 100000;
+    MultiQueue<int> shared(thread_count);
+    std::vector<std::vector<int>> popped_by(thread_count);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < thread_count; t++) {
+        threads.emplace_back([&, t]() {
+            int value;
+            for (int k = 0; k < per_thread; k++) {
+                shared.push(k * thread_count + t);
+                if (k % 2 == 1 && shared.try_pop(value)) popped_by[t].push_back(value);
+            }
+            while (shared.try_pop(value)) popped_by[t].push_back(value);
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    std::vector<int> all;
+    for (auto& values : popped_by) all.insert(all.end(), values.begin(), values.end());
+    std::sort(all.begin(), all.end());
+    bool exactly_once = all.size() == (size_t) per_thread * thread_count;
+    for (size_t i = 0; exactly_once && i < all.size(); i++) exactly_once = all[i] == (int) i;
+    std::cout << (exactly_once ? "every element popped exactly once" : "ELEMENTS LOST OR DUPLICATED") << " by "
+              << thread_count << " threads, " << shared.size() << " left" << std::endl;
+
+    return 0;
+}
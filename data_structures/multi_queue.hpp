@@ -0,0 +1,123 @@
+#ifndef MULTI_QUEUE_HPP
+#define MULTI_QUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "priority_queue.hpp"
+
+// Relaxed concurrent priority queue (a MultiQueue, after Rihani, Sanders and Dementiev): c * T sequential heaps
+// for T threads, each behind its own try-lock. push inserts into a random heap; pop locks two random heaps and
+// pops the better of their tops. A busy lock is never waited on, another heap is sampled instead, so threads
+// rarely contend. In exchange pop returns an element close to the top rather than the top itself: with c * T
+// heaps the expected rank of a popped element is O(c * T), independent of the queue size.
+template<typename T, typename Compare = std::less<T>, size_t Arity = 4>
+class MultiQueue {
+private:
+    struct alignas(64) SubQueue {
+        std::atomic<bool> locked{ false };
+        std::atomic<size_t> count{ 0 }; // heap.size(), written under the lock so size() can read it without one
+        priority_queue<T, std::vector<T>, Compare, Arity> heap;
+
+        bool try_lock() {
+            return !locked.load(std::memory_order_relaxed) && !locked.exchange(true, std::memory_order_acquire);
+        }
+
+        // Release the lock, publishing the heap's new size
+        void unlock() {
+            count.store(heap.size(), std::memory_order_relaxed);
+            locked.store(false, std::memory_order_release);
+        }
+    };
+
+    std::vector<SubQueue> queues;
+    Compare comp;
+
+    // Per-thread xorshift generator, seeded differently in every thread
+    static uint64_t random() {
+        static std::atomic<uint64_t> seeds{ 0x9e3779b97f4a7c15 };
+        thread_local uint64_t state = seeds.fetch_add(0x9e3779b97f4a7c15, std::memory_order_relaxed) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    SubQueue& random_queue() {
+        return queues[random() % queues.size()];
+    }
+
+    // Lock a random sub-queue, sampling again while the chosen one is busy
+    SubQueue& lock_random_queue() {
+        while (true) {
+            SubQueue& queue = random_queue();
+            if (queue.try_lock()) return queue;
+        }
+    }
+
+public:
+    MultiQueue(unsigned thread_count = std::thread::hardware_concurrency(), unsigned queues_per_thread = 2,
+               const Compare& compare = Compare())
+        : queues(std::max(2u, std::max(1u, thread_count) * std::max(1u, queues_per_thread))), comp(compare) {}
+
+    void push(const T& value) {
+        SubQueue& queue = lock_random_queue();
+        queue.heap.push(value);
+        queue.unlock();
+    }
+
+    // Pop an element near the top into value; returns false if the queue was found empty
+    bool try_pop(T& value) {
+        for (int attempt = 0; attempt < 8; attempt++) {
+            SubQueue& first = lock_random_queue();
+            SubQueue& second = random_queue();
+            SubQueue* best = &first;
+            if (&second != &first && second.try_lock()) {
+                if (second.heap.empty() || (!first.heap.empty() && !comp(first.heap.top(), second.heap.top()))) {
+                    second.unlock();
+                } else {
+                    first.unlock();
+                    best = &second;
+                }
+            }
+
+            bool found = !best->heap.empty();
+            if (found) {
+                value = best->heap.top();
+                best->heap.pop();
+            }
+            best->unlock();
+            if (found) return true;
+        }
+
+        // Sampling keeps finding empty heaps, so the queue is nearly empty: look through every heap in turn
+        for (SubQueue& queue : queues) {
+            while (!queue.try_lock()) std::this_thread::yield();
+            bool found = !queue.heap.empty();
+            if (found) {
+                value = queue.heap.top();
+                queue.heap.pop();
+            }
+            queue.unlock();
+            if (found) return true;
+        }
+        return false;
+    }
+
+    // Number of elements, summed over the heaps without locking them: safe to call at any time, but only exact
+    // while no thread is pushing or popping
+    size_t size() const {
+        size_t total = 0;
+        for (const SubQueue& queue : queues) total += queue.count.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+};
+
+#endif
@@ -0,0 +1,154 @@
+// Benchmark MultiQueue against priority_queue behind one mutex, for 1 to 64 threads (or up to the first
+// argument), on min-queues of random integer keys.
+//
+// Both queues are filled with `n` keys (default 1 << 20, or the second argument), then every thread repeatedly
+// pops an element and pushes a fresh random key, the steady state of a scheduler. Reported per thread count:
+//   Mops/s        pops and pushes per second over all threads
+//   rank error    of each popped key among the keys queued at that moment (0 for an exact queue), mean and
+//                 maximum. Measured in a second run that stamps every operation from a global counter and then
+//                 replays the stamps in order, so it slightly perturbs the interleaving it measures.
+// The MultiQueue's rank error bound assumes no more threads than cores: a thread descheduled while it holds a
+// heap's lock hides that heap's best keys for a whole time slice, and the error grows with the slice.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "multi_queue.hpp"
+#include "priority_queue.hpp"
+
+const uint32_t KEY_RANGE = 1 << 24;
+
+struct LockedQueue {
+    std::mutex mutex;
+    priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>, 4> heap;
+
+    LockedQueue(unsigned) {}
+
+    void push(uint32_t value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        heap.push(value);
+    }
+
+    bool try_pop(uint32_t& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (heap.empty()) return false;
+        value = heap.top();
+        heap.pop();
+        return true;
+    }
+};
+
+struct Relaxed : MultiQueue<uint32_t, std::greater<uint32_t>> {
+    Relaxed(unsigned thread_count) : MultiQueue(thread_count) {}
+};
+
+struct Operation {
+    uint64_t stamp;
+    uint32_t key;
+    bool pop;
+};
+
+// Run `per_thread` pop-push pairs on every thread, logging each operation if `log` is given; returns seconds
+template<typename Queue>
+double run(Queue& queue, unsigned thread_count, size_t per_thread, std::vector<std::vector<Operation>>* log) {
+    std::atomic<uint64_t> clock(0);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < thread_count; t++) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 random(t + 1);
+            uint32_t key;
+            for (size_t k = 0; k < per_thread; k++) {
+                if (queue.try_pop(key) && log) (*log)[t].push_back({ clock.fetch_add(1), key, true });
+                uint32_t pushed = random() % KEY_RANGE;
+                if (log) (*log)[t].push_back({ clock.fetch_add(1), pushed, false });
+                queue.push(pushed);
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Replay the logged operations in stamp order over a Fenwick tree of queued keys, measuring how many queued keys
+// were smaller than each popped one
+void rank_error(const std::vector<uint32_t>& initial, std::vector<std::vector<Operation>>& log, double& mean,
+                uint64_t& maximum) {
+    std::vector<Operation> operations;
+    for (auto& thread_log : log) operations.insert(operations.end(), thread_log.begin(), thread_log.end());
+    std::sort(operations.begin(), operations.end(), [](const Operation& a, const Operation& b) {
+        return a.stamp < b.stamp;
+    });
+
+    std::vector<int32_t> tree(KEY_RANGE + 1, 0);
+    auto add = [&](uint32_t key, int32_t delta) {
+        for (size_t i = key + 1; i <= KEY_RANGE; i += i & -i) tree[i] += delta;
+    };
+    auto smaller = [&](uint32_t key) {
+        int64_t count = 0;
+        for (size_t i = key; i > 0; i -= i & -i) count += tree[i];
+        return count;
+    };
+
+    for (uint32_t key : initial) add(key, 1);
+    uint64_t total = 0, pops = 0;
+    maximum = 0;
+    for (const Operation& operation : operations) {
+        if (operation.pop) {
+            uint64_t rank = std::max<int64_t>(smaller(operation.key), 0);
+            total += rank;
+            maximum = std::max(maximum, rank);
+            pops++;
+            add(operation.key, -1);
+        } else {
+            add(operation.key, 1);
+        }
+    }
+    mean = pops ? (double) total / pops : 0;
+}
+
+template<typename Queue>
+void measure(const char* name, unsigned thread_count, const std::vector<uint32_t>& initial, size_t operations) {
+    size_t per_thread = operations / thread_count;
+
+    Queue timed(thread_count);
+    for (uint32_t key : initial) timed.push(key);
+    double seconds = run(timed, thread_count, per_thread, nullptr);
+
+    Queue logged(thread_count);
+    for (uint32_t key : initial) logged.push(key);
+    std::vector<std::vector<Operation>> log(thread_count);
+    for (auto& thread_log : log) thread_log.reserve(2 * per_thread);
+    run(logged, thread_count, per_thread, &log);
+    double mean;
+    uint64_t maximum;
+    rank_error(initial, log, mean, maximum);
+
+    printf("%-20s %8u %12.2f %14.1f %12llu\n", name, thread_count, 2.0 * per_thread * thread_count / seconds / 1e6,
+           mean, (unsigned long long) maximum);
+}
+
+int main(int argc, char* argv[]) {
+    unsigned max_threads = argc > 1 ? atoi(argv[1]) : 64;
+    size_t n = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1 << 20;
+    size_t operations = n;
+
+    std::mt19937 random(0);
+    std::vector<uint32_t> initial(n);
+    for (uint32_t& key : initial) key = random() % KEY_RANGE;
+
+    printf("%-20s %8s %12s %14s %12s\n", "queue", "threads", "Mops/s", "mean rank err", "max rank err");
+    for (unsigned thread_count = 1; thread_count <= max_threads; thread_count *= 2) {
+        measure<LockedQueue>("mutex + heap", thread_count, initial, operations);
+        measure<Relaxed>("MultiQueue c=2", thread_count, initial, operations);
+    }
+    return 0;
+}
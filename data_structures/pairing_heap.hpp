@@ -0,0 +1,271 @@
+#ifndef PAIRING_HEAP_HPP
+#define PAIRING_HEAP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Pairing heap: a heap-ordered tree whose root holds the largest (by default) element. push and meld link two
+// trees in O(1), increase_key cuts a subtree out and links it back to the root in O(1), and pop links the root's
+// children in pairs, left to right, then the pairs right to left, in O(log n) amortised.
+//
+// Nodes come from a pool of fixed-size blocks recycled through a free list, and never move, so the handle that
+// push returns names its element until that element is popped, even across a meld into another heap. As in
+// addressable_priority_queue, increase_key follows Compare: it moves an element towards the top, which for a
+// min-queue (std::greater) is the textbook decrease-key. Heaps own their nodes, so they can be moved but not
+// copied.
+template<typename T, typename Compare = std::less<T>>
+class pairing_heap {
+private:
+    struct Node {
+        Node* child;         // leftmost child
+        Node* next;          // next sibling, or next free node in the pool
+        Node* prev;          // previous sibling, or the parent of a leftmost child
+        union { T value; };  // constructed only while the node is in use
+
+        Node() {}
+        ~Node() {}
+    };
+
+    static constexpr size_t BLOCK_SIZE = 1024;
+
+    std::list<std::unique_ptr<Node[]>> blocks;
+    Node* free_head = nullptr;
+    Node* free_tail = nullptr;
+    Node* root = nullptr;
+    size_t count = 0;
+    Compare comp;
+
+    Node* allocate() {
+        if (!free_head) {
+            blocks.emplace_back(new Node[BLOCK_SIZE]);
+            Node* block = blocks.back().get();
+            for (size_t i = 0; i < BLOCK_SIZE; i++) block[i].next = i + 1 < BLOCK_SIZE ? &block[i + 1] : nullptr;
+            free_head = block;
+            free_tail = &block[BLOCK_SIZE - 1];
+        }
+
+        Node* node = free_head;
+        free_head = node->next;
+        if (!free_head) free_tail = nullptr;
+        node->child = node->next = node->prev = nullptr;
+        return node;
+    }
+
+    void release(Node* node) {
+        node->value.~T();
+        node->next = free_head;
+        free_head = node;
+        if (!free_tail) free_tail = node;
+    }
+
+    // Make the root of lower priority the leftmost child of the other; returns the new root
+    Node* link(Node* a, Node* b) {
+        if (comp(a->value, b->value)) std::swap(a, b);
+        b->next = a->child;
+        if (a->child) a->child->prev = b;
+        b->prev = a;
+        a->child = b;
+        return a;
+    }
+
+    // Two-pass pairing of a sibling list: link neighbours left to right, chaining the results backwards through
+    // prev, then link the chain right to left into one tree
+    Node* merge_pairs(Node* first) {
+        if (!first) return nullptr;
+
+        Node* last = nullptr;
+        while (first) {
+            Node* a = first;
+            Node* b = a->next;
+            if (!b) {
+                a->next = nullptr;
+                a->prev = last;
+                last = a;
+                break;
+            }
+            first = b->next;
+            a->next = b->next = nullptr;
+            Node* merged = link(a, b);
+            merged->prev = last;
+            last = merged;
+        }
+
+        Node* result = last;
+        last = last->prev;
+        while (last) {
+            Node* previous = last->prev;
+            result = link(last, result);
+            last = previous;
+        }
+        result->prev = nullptr;
+        return result;
+    }
+
+    Node* insert(Node* node) {
+        root = root ? link(root, node) : node;
+        root->prev = nullptr;
+        count++;
+        return node;
+    }
+
+public:
+    using handle = Node*;
+
+    // Default constructor
+    pairing_heap() = default;
+
+    explicit pairing_heap(const Compare& compare) : comp(compare) {}
+
+    pairing_heap(const pairing_heap&) = delete;
+    pairing_heap& operator=(const pairing_heap&) = delete;
+
+    pairing_heap(pairing_heap&& other) noexcept : comp(other.comp) {
+        swap(other);
+    }
+
+    pairing_heap& operator=(pairing_heap&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~pairing_heap() {
+        // The pool frees the memory; the elements still in the heap have to be destroyed first
+        std::vector<Node*> pending;
+        if (root) pending.push_back(root);
+        while (!pending.empty()) {
+            Node* node = pending.back();
+            pending.pop_back();
+            if (node->child) pending.push_back(node->child);
+            if (node->next) pending.push_back(node->next);
+            node->value.~T();
+        }
+    }
+
+    // Get the top element of the heap
+    const T& top() const {
+        if (!root) {
+            throw std::out_of_range("pairing_heap is empty");
+        }
+
+        return root->value;
+    }
+
+    // Check if the heap is empty
+    bool empty() const {
+        return count == 0;
+    }
+
+    // Get the size of the heap
+    size_t size() const {
+        return count;
+    }
+
+    // Push an element (l-value) into the heap, returning its handle
+    handle push(const T& value) {
+        return emplace(value);
+    }
+
+    // Push an element (r-value) into the heap, returning its handle
+    handle push(T&& value) {
+        return emplace(std::move(value));
+    }
+
+    // Emplace an element into the heap, returning its handle
+    template<typename... Args>
+    handle emplace(Args&&... args) {
+        Node* node = allocate();
+        try {
+            new (&node->value) T(std::forward<Args>(args)...);
+        } catch (...) {
+            node->next = free_head;
+            free_head = node;
+            if (!free_tail) free_tail = node;
+            throw;
+        }
+        return insert(node);
+    }
+
+    // Pop the top element from the heap; its handle becomes invalid
+    void pop() {
+        if (!root) {
+            return;
+        }
+
+        Node* old_root = root;
+        root = merge_pairs(root->child);
+        release(old_root);
+        count--;
+    }
+
+    // Get the element named by a handle
+    const T& value(handle h) const {
+        return h->value;
+    }
+
+    // Replace the element named by h with one that Compare ranks no lower, moving it towards the top
+    void increase_key(handle h, T value) {
+        if (comp(value, h->value)) {
+            throw std::invalid_argument("increase_key given a value of lower priority");
+        }
+
+        h->value = std::move(value);
+        if (h == root) {
+            return;
+        }
+
+        // Cut h's subtree out of its sibling list and link it back in at the root
+        if (h->prev->child == h) {
+            h->prev->child = h->next;
+        } else {
+            h->prev->next = h->next;
+        }
+        if (h->next) h->next->prev = h->prev;
+        h->next = h->prev = nullptr;
+        root = link(root, h);
+    }
+
+    // Move every element of other into this heap in O(1), leaving other empty. Handles into other stay valid
+    // and now name elements of this heap.
+    void meld(pairing_heap& other) {
+        if (this == &other || !other.root) {
+            return;
+        }
+
+        root = root ? link(root, other.root) : other.root;
+        root->prev = nullptr;
+        count += other.count;
+        blocks.splice(blocks.end(), other.blocks);
+        if (other.free_head) {
+            other.free_tail->next = free_head;
+            free_head = other.free_head;
+            if (!free_tail) free_tail = other.free_tail;
+        }
+
+        other.root = other.free_head = other.free_tail = nullptr;
+        other.count = 0;
+    }
+
+    // Swap contents with another heap
+    void swap(pairing_heap& other) {
+        std::swap(blocks, other.blocks);
+        std::swap(free_head, other.free_head);
+        std::swap(free_tail, other.free_tail);
+        std::swap(root, other.root);
+        std::swap(count, other.count);
+        std::swap(comp, other.comp);
+    }
+};
+
+// Non-member swap function
+template<typename T, typename Compare>
+void swap(pairing_heap<T, Compare>& lhs, pairing_heap<T, Compare>& rhs) {
+    lhs.swap(rhs); // Forward to the member swap function
+}
+
+#endif
@@ -1,114 +1,6 @@
-#include <algorithm>
-#include <functional>
 #include <iostream>
-#include <stdexcept>
-#include <utility>
 #include <vector>
-
-// Container adapter for efficient retrieval of the largest (by default) element.
-// The user can supply a different Container type and Compare type.
-template<typename T, typename Container = std::vector<T>, typename Compare = std::less<T>>
-class priority_queue {
-private:
-    Container c;
-    Compare comp;
-
-    // Helper function to maintain the heap property
-    void heapify_up(size_t index) {
-        while (index > 0) {
-            size_t parent = (index - 1) / 2;
-            if (comp(c[parent], c[index])) {
-                std::swap(c[parent], c[index]);
-                index = parent;
-            } else {
-                break;
-            }
-        }
-    }
-
-    // Helper function to maintain the heap property
-    void heapify_down(size_t index) {
-        size_t left_child = 2 * index + 1;
-        size_t right_child = 2 * index + 2;
-        size_t largest = index;
-
-        if (left_child < c.size() && comp(c[largest], c[left_child])) {
-            largest = left_child;
-        }
-
-        if (right_child < c.size() && comp(c[largest], c[right_child])) {
-            largest = right_child;
-        }
-
-        if (largest != index) {
-            std::swap(c[largest], c[index]);
-            heapify_down(largest);
-        }
-    }
-
-public:
-    // Default constructor
-    priority_queue() = default;
-
-    // Get the top element of the priority queue
-    const T& top() const {
-        if (c.empty()) {
-            throw std::out_of_range("priority_queue is empty");
-        }
-
-        return c.front();
-    }
-
-    // Check if the priority queue is empty
-    bool empty() const {
-        return c.empty();
-    }
-
-    // Get the size of the priority queue
-    size_t size() const {
-        return c.size();
-    }
-
-    // Push an element (l-value) into the priority queue
-    void push(const T& value) {
-        c.push_back(value); // Add to the end of the container
-        heapify_up(c.size() - 1); // Restore heap property
-    }
-
-    // Push an element (r-value) into the priority queue
-    void push(T&& value) {
-        c.push_back(std::move(value)); // Add to the end of the container
-        heapify_up(c.size() - 1); // Restore heap property
-    }
-
-    // Emplace an element into the priority queue
-    template<typename... Args>
-    void emplace(Args&&... args) {
-        c.emplace_back(std::forward<Args>(args)...); // Emplace at the end of the container
-        heapify_up(c.size() - 1); // Restore heap property
-    }
-
-    // Pop the top element from the priority queue
-    void pop() {
-        if (!c.empty()) {
-            std::swap(c.front(), c.back()); // Move the last element to the top
-            c.pop_back(); // Remove the last element
-            heapify_down(0); // Restore heap property
-        }
-    }
-
-    // Swap contents with another priority queue
-    void swap(priority_queue& other) {
-        std::swap(c, other.c);
-        std::swap(comp, other.comp);
-    }
-};
-
-// Non-member swap function
-template<typename T, typename Container, typename Compare>
-void swap(priority_queue<T, Container, Compare>& lhs, priority_queue<T, Container, Compare>& rhs) {
-    lhs.swap(rhs); // Forward to the member swap function
-}
+#include "priority_queue.hpp"
 
 // Testing the data structure
 int main() {
@@ -176,5 +68,21 @@ int main() {
     }
     std::cout << std::endl;
 
+    std::vector<int> values = { 5, 3, 9, 1, 7, 2, 8 };
+    priority_queue<int, std::vector<int>, std::less<int>, 4> quaternary_pq(values.begin(), values.end());
+    quaternary_pq.push_range(values.begin(), values.begin() + 2);
+    std::cout << "Heapified 4-ary priority queue with 5 and 3 pushed again: ";
+    while (!quaternary_pq.empty()) {
+        std::cout << quaternary_pq.top() << " ";
+        quaternary_pq.pop();
+    }
+    std::cout << std::endl;
+
+    priority_queue<int, std::vector<int>, std::greater<int>, 8> octonary_pq(values.begin(), values.end());
+    octonary_pq.replace_top(6);
+    std::cout << "Top element in 8-ary min priority queue after replacing 1 with 6: " << octonary_pq.top() << std::endl;
+    std::cout << "Popped by pop_push(4): " << octonary_pq.pop_push(4) << ", then by pop_push(0): " << octonary_pq.pop_push(0)
+              << std::endl;
+
     return 0;
 }
@@ -0,0 +1,191 @@
+#ifndef PRIORITY_QUEUE_HPP
+#define PRIORITY_QUEUE_HPP
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Container adapter for efficient retrieval of the largest (by default) element.
+// The user can supply a different Container type and Compare type, and the number of children per node:
+// wider heaps are shallower, so sifting down compares more siblings per level but touches fewer cache lines.
+template<typename T, typename Container = std::vector<T>, typename Compare = std::less<T>, size_t Arity = 2>
+class priority_queue {
+    static_assert(Arity >= 2, "a heap node needs at least two children");
+
+private:
+    Container c;
+    Compare comp;
+
+    // Helper function to maintain the heap property: move the element at index up past smaller parents,
+    // shifting each parent down into the hole instead of swapping
+    void heapify_up(size_t index) {
+        T value = std::move(c[index]);
+        while (index > 0) {
+            size_t parent = (index - 1) / Arity;
+            if (!comp(c[parent], value)) {
+                break;
+            }
+            c[index] = std::move(c[parent]);
+            index = parent;
+        }
+        c[index] = std::move(value);
+    }
+
+    // Helper function to maintain the heap property: move the element at index down past larger children,
+    // shifting the largest child up into the hole at each level
+    void heapify_down(size_t index) {
+        size_t size = c.size();
+        T value = std::move(c[index]);
+        while (true) {
+            size_t first_child = Arity * index + 1;
+            if (first_child >= size) {
+                break;
+            }
+
+            size_t largest = first_child, end = std::min(first_child + Arity, size);
+            for (size_t child = first_child + 1; child < end; child++) {
+                largest = comp(c[largest], c[child]) ? child : largest; // a select rather than a branch
+            }
+
+            if (!comp(value, c[largest])) {
+                break;
+            }
+            c[index] = std::move(c[largest]);
+            index = largest;
+        }
+        c[index] = std::move(value);
+    }
+
+    // Floyd's bottom-up heap construction: sift down every internal node, deepest first, in O(n)
+    void make_heap() {
+        if (c.size() > 1) {
+            for (size_t index = (c.size() - 2) / Arity + 1; index-- > 0;) {
+                heapify_down(index);
+            }
+        }
+    }
+
+public:
+    // Default constructor
+    priority_queue() = default;
+
+    explicit priority_queue(const Compare& compare) : comp(compare) {}
+
+    // Construct from a range of elements, heapified in O(n)
+    template<typename InputIt>
+    priority_queue(InputIt first, InputIt last, const Compare& compare = Compare()) : c(first, last), comp(compare) {
+        make_heap();
+    }
+
+    // Get the top element of the priority queue
+    const T& top() const {
+        if (c.empty()) {
+            throw std::out_of_range("priority_queue is empty");
+        }
+
+        return c.front();
+    }
+
+    // Check if the priority queue is empty
+    bool empty() const {
+        return c.empty();
+    }
+
+    // Get the size of the priority queue
+    size_t size() const {
+        return c.size();
+    }
+
+    // Allocate room for `capacity` elements up front
+    void reserve(size_t capacity) {
+        c.reserve(capacity);
+    }
+
+    // Push an element (l-value) into the priority queue
+    void push(const T& value) {
+        c.push_back(value); // Add to the end of the container
+        heapify_up(c.size() - 1); // Restore heap property
+    }
+
+    // Push an element (r-value) into the priority queue
+    void push(T&& value) {
+        c.push_back(std::move(value)); // Add to the end of the container
+        heapify_up(c.size() - 1); // Restore heap property
+    }
+
+    // Push a range of elements. When the range is at least as large as the queue, the whole container is
+    // heapified again in O(n) rather than sifting each new element up.
+    template<typename InputIt>
+    void push_range(InputIt first, InputIt last) {
+        size_t old_size = c.size();
+        c.insert(c.end(), first, last);
+        if (c.size() - old_size >= old_size) {
+            make_heap();
+        } else {
+            for (size_t index = old_size; index < c.size(); index++) {
+                heapify_up(index);
+            }
+        }
+    }
+
+    // Emplace an element into the priority queue
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        c.emplace_back(std::forward<Args>(args)...); // Emplace at the end of the container
+        heapify_up(c.size() - 1); // Restore heap property
+    }
+
+    // Pop the top element from the priority queue
+    void pop() {
+        if (c.empty()) {
+            return;
+        }
+
+        T value = std::move(c.back()); // Take out the last element
+        c.pop_back();
+        if (c.empty()) {
+            return;
+        }
+
+        c.front() = std::move(value);
+        heapify_down(0);
+    }
+
+    // Replace the top element with `value` in a single sift, instead of a pop followed by a push
+    void replace_top(T value) {
+        if (c.empty()) {
+            throw std::out_of_range("priority_queue is empty");
+        }
+
+        c.front() = std::move(value);
+        heapify_down(0);
+    }
+
+    // Push `value` and pop the top element in a single sift, returning the popped element (which is `value`
+    // itself if nothing in the queue outranks it)
+    T pop_push(T value) {
+        if (c.empty() || !comp(value, c.front())) {
+            return value;
+        }
+
+        std::swap(value, c.front());
+        heapify_down(0);
+        return value;
+    }
+
+    // Swap contents with another priority queue
+    void swap(priority_queue& other) {
+        std::swap(c, other.c);
+        std::swap(comp, other.comp);
+    }
+};
+
+// Non-member swap function
+template<typename T, typename Container, typename Compare, size_t Arity>
+void swap(priority_queue<T, Container, Compare, Arity>& lhs, priority_queue<T, Container, Compare, Arity>& rhs) {
+    lhs.swap(rhs); // Forward to the member swap function
+}
+
+#endif
@@ -0,0 +1,142 @@
+// Benchmark priority_queue.hpp at arities 2, 4 and 8 against std::priority_queue, for int elements and for
+// 32 byte elements (an integer key followed by 24 bytes of payload).
+//
+// Workloads, each over `n` elements (default 1 << 20, or the first argument):
+//   push+pop   push n random keys one at a time, then pop them all
+//   heapify    build the queue from a range of n random keys, then pop them all
+//   hold       keep n keys queued and n times replace the top with a later key, as schedulers and
+//              event simulations do: replace_top here, pop followed by push for std::priority_queue
+// Every row reports millions of heap operations per second; the checksum keeps the work from being optimised
+// away and must agree between implementations.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+#include "priority_queue.hpp"
+
+struct Payload32 {
+    uint64_t key;
+    uint64_t data[3];
+
+    Payload32(uint64_t key = 0) : key(key), data{ key, key, key } {}
+
+    bool operator<(const Payload32& other) const {
+        return key < other.key;
+    }
+};
+
+uint64_t key_of(int value) {
+    return value;
+}
+
+uint64_t key_of(const Payload32& value) {
+    return value.key;
+}
+
+// Min-heaps throughout, so the hold workload can keep pushing later keys
+template<typename T>
+struct Later {
+    bool operator()(const T& a, const T& b) const {
+        return b < a;
+    }
+};
+
+// Thin wrappers giving both implementations the same interface
+template<typename T, size_t Arity>
+struct OurQueue {
+    priority_queue<T, std::vector<T>, Later<T>, Arity> q;
+
+    OurQueue() = default;
+    OurQueue(const std::vector<T>& values) : q(values.begin(), values.end()) {}
+    void push(const T& value) { q.push(value); }
+    const T& top() const { return q.top(); }
+    void pop() { q.pop(); }
+    bool empty() const { return q.empty(); }
+    void replace_top(const T& value) { q.replace_top(value); }
+};
+
+template<typename T>
+struct StdQueue {
+    std::priority_queue<T, std::vector<T>, Later<T>> q;
+
+    StdQueue() = default;
+    StdQueue(const std::vector<T>& values) : q(values.begin(), values.end()) {}
+    void push(const T& value) { q.push(value); }
+    const T& top() const { return q.top(); }
+    void pop() { q.pop(); }
+    bool empty() const { return q.empty(); }
+    void replace_top(const T& value) { q.pop(); q.push(value); }
+};
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename Queue, typename T>
+void run(const char* implementation, const char* type, const std::vector<T>& keys, const std::vector<uint32_t>& steps) {
+    size_t n = keys.size();
+    uint64_t checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        Queue q;
+        for (const T& key : keys) q.push(key);
+        while (!q.empty()) {
+            checksum += key_of(q.top());
+            q.pop();
+        }
+    }
+    double push_pop = 2 * n / seconds_since(start) / 1e6;
+
+    start = std::chrono::steady_clock::now();
+    {
+        Queue q(keys);
+        while (!q.empty()) {
+            checksum += key_of(q.top());
+            q.pop();
+        }
+    }
+    double heapify = n / seconds_since(start) / 1e6;
+
+    Queue q(keys);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t step : steps) {
+        uint64_t key = key_of(q.top());
+        checksum += key;
+        q.replace_top(T(key + step));
+    }
+    double hold = n / seconds_since(start) / 1e6;
+
+    printf("%-24s %-10s %12.1f %12.1f %12.1f   %016llx\n", implementation, type, push_pop, heapify, hold,
+           (unsigned long long) checksum);
+}
+
+template<typename T>
+void run_all(const char* type, size_t n) {
+    std::mt19937_64 random(1);
+    std::vector<T> keys;
+    std::vector<uint32_t> steps;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        keys.push_back(T(random() % (1u << 30)));
+        steps.push_back(1 + random() % 1024); // keeps int keys below 2^31 for n up to 2^20
+    }
+
+    run<StdQueue<T>>("std::priority_queue", type, keys, steps);
+    run<OurQueue<T, 2>>("priority_queue arity 2", type, keys, steps);
+    run<OurQueue<T, 4>>("priority_queue arity 4", type, keys, steps);
+    run<OurQueue<T, 8>>("priority_queue arity 8", type, keys, steps);
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1 << 20;
+    printf("%-24s %-10s %12s %12s %12s   %s\n", "implementation", "element", "push+pop", "heapify", "hold", "checksum");
+    run_all<int>("int", n);
+    run_all<Payload32>("32 bytes", n);
+    return 0;
+}
@@ -0,0 +1,153 @@
+#ifndef RADIX_HEAP_HPP
+#define RADIX_HEAP_HPP
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Unsigned integer key of a radix_heap element: the element itself, or the first member of a pair such as the
+// (distance, vertex) entries of a shortest-path search. Specialise it for other element types.
+template<typename T>
+struct radix_key {
+    T operator()(const T& value) const {
+        return value;
+    }
+};
+
+template<typename Key, typename Value>
+struct radix_key<std::pair<Key, Value>> {
+    Key operator()(const std::pair<Key, Value>& value) const {
+        return value.first;
+    }
+};
+
+// Monotone radix heap: a min-queue of elements with unsigned integer keys, for workloads such as event
+// simulation and Dijkstra's algorithm that never push a key below the current minimum. Bucket 0 holds the
+// elements whose key equals the current minimum `last`, and bucket i those whose key first differs from `last`
+// in bit i - 1. When bucket 0 runs out, the lowest non-empty bucket supplies the new minimum and its elements
+// are spread over lower buckets; an element only ever moves to a lower bucket, so each costs O(bits of Key)
+// over its lifetime, with no comparisons between elements at all.
+//
+// Compare must be std::greater<T>, the min-queue order, so the heap can stand in for a priority_queue used as
+// a min-queue. Elements with equal keys come out in no particular order.
+template<typename T, typename Compare = std::greater<T>, typename KeyOf = radix_key<T>>
+class radix_heap {
+private:
+    using Key = std::decay_t<decltype(std::declval<KeyOf>()(std::declval<const T&>()))>;
+    static_assert(std::is_unsigned<Key>::value, "radix_heap keys must be unsigned integers");
+    static_assert(std::is_same<Compare, std::greater<T>>::value, "radix_heap is a min-queue: Compare must be std::greater<T>");
+
+    static constexpr size_t BITS = std::numeric_limits<Key>::digits;
+
+    // Refilling bucket 0 happens on demand, from top() as well as pop(), so the buckets are mutable
+    mutable std::array<std::vector<T>, BITS + 1> buckets;
+    mutable Key last = 0;
+    size_t count = 0;
+    KeyOf key_of;
+
+    static size_t bit_width(Key x) {
+#if defined(__GNUC__)
+        return x == 0 ? 0 : std::numeric_limits<unsigned long long>::digits - __builtin_clzll(x);
+#else
+        size_t width = 0;
+        for (; x; x >>= 1) width++;
+        return width;
+#endif
+    }
+
+    size_t bucket_of(Key key) const {
+        return bit_width(key ^ last);
+    }
+
+    // Take the new minimum from the lowest non-empty bucket and spread that bucket over the lower ones
+    void refill() const {
+        size_t i = 1;
+        while (buckets[i].empty()) i++;
+
+        last = key_of(buckets[i].front());
+        for (const T& value : buckets[i]) {
+            Key key = key_of(value);
+            if (key < last) last = key;
+        }
+        for (T& value : buckets[i]) {
+            size_t bucket = bucket_of(key_of(value));
+            buckets[bucket].push_back(std::move(value));
+        }
+        buckets[i].clear();
+    }
+
+public:
+    // Default constructor
+    radix_heap() = default;
+
+    explicit radix_heap(const Compare&) {}
+
+    // Get the element with the smallest key
+    const T& top() const {
+        if (count == 0) {
+            throw std::out_of_range("radix_heap is empty");
+        }
+
+        if (buckets[0].empty()) refill();
+        return buckets[0].back();
+    }
+
+    // Check if the heap is empty
+    bool empty() const {
+        return count == 0;
+    }
+
+    // Get the size of the heap
+    size_t size() const {
+        return count;
+    }
+
+    // Push an element whose key is no smaller than the last key returned by top or pop
+    void push(T value) {
+        Key key = key_of(value);
+        if (key < last) {
+            throw std::invalid_argument("radix_heap key below the current minimum");
+        }
+
+        buckets[bucket_of(key)].push_back(std::move(value));
+        count++;
+    }
+
+    // Emplace an element into the heap
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        push(T(std::forward<Args>(args)...));
+    }
+
+    // Pop the element with the smallest key
+    void pop() {
+        if (count == 0) {
+            return;
+        }
+
+        if (buckets[0].empty()) refill();
+        buckets[0].pop_back();
+        count--;
+    }
+
+    // Swap contents with another heap
+    void swap(radix_heap& other) {
+        std::swap(buckets, other.buckets);
+        std::swap(last, other.last);
+        std::swap(count, other.count);
+        std::swap(key_of, other.key_of);
+    }
+};
+
+// Non-member swap function
+template<typename T, typename Compare, typename KeyOf>
+void swap(radix_heap<T, Compare, KeyOf>& lhs, radix_heap<T, Compare, KeyOf>& rhs) {
+    lhs.swap(rhs); // Forward to the member swap function
+}
+
+#endif
@@ -0,0 +1,184 @@
+// Union-find that can undo joins, and an offline dynamic connectivity solver built on it.
+//
+// RollbackDisjointSet links by size and never compresses paths, so a join changes exactly one parent and one
+// size, which the undo stack records; rollback(snapshot()) then restores an earlier state in O(1) per join
+// undone, and finds stay O(log n).
+//
+// The solver reads every operation first. Each edge is alive over an interval of operations, from its
+// insertion to its deletion, and that interval is stored in the O(log q) nodes of a segment tree over time that
+// cover it. A depth-first walk of the tree joins a node's edges on the way down and rolls them back on the way
+// up, so at each leaf exactly the edges alive at that time are joined: O(log q log n) per operation overall.
+//
+// Input: the vertex count n and operation count q, then q lines of "add u v", "remove u v", "connected u v"
+// or "count" (the number of connected components), vertices numbered 0 .. n - 1. An edge added several times
+// stays until removed as often. Each "connected" and "count" is answered on its own line.
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+class RollbackDisjointSet {
+private:
+    std::vector<int> root, child_count;
+    std::vector<int> attached; // root attached by each join still in effect, most recent last
+    int sets;
+
+public:
+    RollbackDisjointSet(int n) : sets(n) {
+        root = child_count = std::vector<int>(n, 1);
+        for (int i = 0; i < n; i++) root[i] = i;
+    }
+
+    // No path compression, so a find never writes and an undo never has to restore one
+    int find(int i) const {
+        while (i != root[i]) i = root[i];
+        return i;
+    }
+
+    // Merge the sets of i and j; returns false (recording nothing) if they were already the same set
+    bool join(int i, int j) {
+        int i_root = find(i), j_root = find(j);
+        if (i_root == j_root) return false;
+
+        // Always attach root of smaller tree to root of larger tree, which bounds tree height by log n
+        if (child_count[i_root] < child_count[j_root]) std::swap(i_root, j_root);
+        root[j_root] = i_root;
+        child_count[i_root] += child_count[j_root];
+        attached.push_back(j_root);
+        sets--;
+        return true;
+    }
+
+    bool are_joint(int i, int j) const {
+        return find(i) == find(j);
+    }
+
+    int count_sets() const {
+        return sets;
+    }
+
+    // Marker for the current state, to be passed to rollback
+    size_t snapshot() const {
+        return attached.size();
+    }
+
+    // Undo every join made since snapshot `to` was taken, most recent first
+    void rollback(size_t to) {
+        while (attached.size() > to) {
+            int j_root = attached.back();
+            attached.pop_back();
+            child_count[root[j_root]] -= child_count[j_root];
+            root[j_root] = j_root;
+            sets++;
+        }
+    }
+};
+
+struct Operation {
+    std::string type;
+    int u, v;
+};
+
+class OfflineConnectivity {
+private:
+    const std::vector<Operation>& operations;
+    std::vector<std::vector<std::pair<int, int>>> alive; // segment tree over operation indices
+    RollbackDisjointSet sets;
+    std::vector<std::string> answers;
+
+    // Store edge (u, v) in the nodes covering [from, to) within node's range [begin, end)
+    void add_interval(size_t node, size_t begin, size_t end, size_t from, size_t to, std::pair<int, int> edge) {
+        if (to <= begin || end <= from) return;
+        if (from <= begin && end <= to) {
+            alive[node].push_back(edge);
+            return;
+        }
+        size_t middle = (begin + end) / 2;
+        add_interval(2 * node, begin, middle, from, to, edge);
+        add_interval(2 * node + 1, middle, end, from, to, edge);
+    }
+
+    void solve(size_t node, size_t begin, size_t end) {
+        size_t snapshot = sets.snapshot();
+        for (auto& [u, v] : alive[node]) sets.join(u, v);
+
+        if (end - begin == 1) {
+            const Operation& operation = operations[begin];
+            if (operation.type == "connected") {
+                answers.push_back(sets.are_joint(operation.u, operation.v) ? "connected" : "not connected");
+            } else if (operation.type == "count") {
+                answers.push_back(std::to_string(sets.count_sets()));
+            }
+        } else {
+            size_t middle = (begin + end) / 2;
+            solve(2 * node, begin, middle);
+            solve(2 * node + 1, middle, end);
+        }
+
+        sets.rollback(snapshot);
+    }
+
+public:
+    OfflineConnectivity(int n, const std::vector<Operation>& operations)
+        : operations(operations), alive(4 * std::max<size_t>(operations.size(), 1)), sets(n) {}
+
+    // Answers to the "connected" and "count" operations in order; false if an edge is removed that is absent
+    bool run(std::vector<std::string>& result) {
+        std::map<std::pair<int, int>, std::vector<size_t>> added; // insertion times of each edge still present
+        for (size_t t = 0; t < operations.size(); t++) {
+            const Operation& operation = operations[t];
+            std::pair<int, int> edge = std::minmax(operation.u, operation.v);
+            if (operation.type == "add") {
+                added[edge].push_back(t);
+            } else if (operation.type == "remove") {
+                auto it = added.find(edge);
+                if (it == added.end()) return false;
+                add_interval(1, 0, operations.size(), it->second.back(), t, edge);
+                it->second.pop_back();
+                if (it->second.empty()) added.erase(it);
+            }
+        }
+        for (auto& [edge, times] : added) {
+            for (size_t t : times) add_interval(1, 0, operations.size(), t, operations.size(), edge);
+        }
+
+        if (!operations.empty()) solve(1, 0, operations.size());
+        result = std::move(answers);
+        return true;
+    }
+};
+
+int main() {
+    int n;
+    size_t q;
+    std::cin >> n >> q;
+    std::vector<Operation> operations(q);
+    for (Operation& operation : operations) {
+        std::cin >> operation.type;
+        operation.u = operation.v = 0;
+        if (operation.type != "count") std::cin >> operation.u >> operation.v;
+        if (!std::cin || (operation.type != "add" && operation.type != "remove" && operation.type != "connected" &&
+                          operation.type != "count")) {
+            std::cout << "Invalid operation." << std::endl;
+            return 1;
+        }
+        if (operation.u < 0 || operation.u >= n || operation.v < 0 || operation.v >= n) {
+            std::cout << "Vertex not found." << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<std::string> answers;
+    if (!OfflineConnectivity(n, operations).run(answers)) {
+        std::cout << "Removed edge not found." << std::endl;
+        return 1;
+    }
+    std::string out;
+    for (const std::string& answer : answers) out += answer + "\n";
+    std::cout << out;
+
+    return 0;
+}
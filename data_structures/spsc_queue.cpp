@@ -0,0 +1,54 @@
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "spsc_queue.hpp"
+
+int main() {
+    // Testing, single-threaded
+    spsc_queue<int> q(3);
+    std::cout << "Capacity rounded up from 3: " << q.capacity() << std::endl; // 4
+    for (int i = 1; i <= 4; i++) q.enqueue(i);
+    std::cout << "Enqueue into full queue: " << (q.try_enqueue(5) ? "succeeded" : "failed") << std::endl; // failed
+    std::cout << q.dequeue() << " " << q.dequeue() << std::endl; // 1 2
+
+    // Batches wrapping around the end of the array
+    int in[] = { 5, 6, 7 }, out[4];
+    std::cout << "Enqueued " << q.enqueue_n(in, 3) << " of 3" << std::endl; // 2 of 3
+    size_t count = q.dequeue_n(out, 4);
+    for (size_t i = 0; i < count; i++) std::cout << out[i] << " ";
+    std::cout << std::endl; // 3 4 5 6
+    int value;
+    std::cout << "Dequeue from empty queue: " << (q.try_dequeue(value) ? "succeeded" : "failed") << std::endl; // failed
+
+    // Testing, a producer and a consumer thread mixing single and batched operations: the consumer must see
+    // every item, in order
+    const uint64_t n = 1 << 22;
+    spsc_queue<uint64_t> shared(1 << 10);
+    std::thread producer([&]() {
+        std::vector<uint64_t> batch;
+        for (uint64_t next = 0; next < n;) {
+            if (next % 3 == 0) {
+                shared.enqueue(next++);
+            } else {
+                batch.clear();
+                for (uint64_t k = 0; k < 100 && next + k < n; k++) batch.push_back(next + k);
+                next += shared.enqueue_n(batch.data(), batch.size());
+            }
+        }
+    });
+    bool in_order = true;
+    std::vector<uint64_t> batch(77);
+    for (uint64_t expected = 0; expected < n;) {
+        if (expected % 2 == 0) {
+            in_order &= shared.dequeue() == expected++;
+        } else {
+            size_t count = shared.dequeue_n(batch.data(), batch.size());
+            for (size_t i = 0; i < count; i++) in_order &= batch[i] == expected++;
+        }
+    }
+    producer.join();
+    std::cout << (in_order ? "all" : "NOT all") << " items received in order, " << shared.size() << " left" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread, such as the stages of a
+// pipeline. The counterpart of resizing_array_queue for passing items between threads:
+//  - the capacity is a power of two, and head and tail count up forever, so a slot is an index masked by
+//    capacity - 1 and the queue is full when tail - head reaches the capacity;
+//  - the consumer's index (head) and the producer's (tail) live on separate cache lines, each next to that
+//    thread's cached copy of the other index. A thread rereads the other's index, with an acquire load
+//    pairing with the other's release store, only when its cached copy says the queue is full (or empty), so
+//    in steady state the two cores do not bounce a cache line on every item;
+//  - enqueue_n and dequeue_n move a whole span with one index update, amortising the synchronisation.
+template<typename T>
+class spsc_queue {
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    // Read-only after construction, shared by both threads
+    size_t mask;
+    std::unique_ptr<T[]> arr;
+
+    // Written by the consumer
+    alignas(CACHE_LINE) std::atomic<size_t> head{ 0 };
+    size_t cached_tail = 0;
+
+    // Written by the producer
+    alignas(CACHE_LINE) std::atomic<size_t> tail{ 0 };
+    size_t cached_head = 0;
+
+    static size_t round_up_to_power_of_two(size_t n) {
+        size_t power = 2;
+        while (power < n) power *= 2;
+        return power;
+    }
+
+    // Free slots seen by the producer, rereading head only if the cached copy shows fewer than `wanted`
+    size_t free_slots(size_t t, size_t wanted) {
+        size_t free = capacity() - (t - cached_head);
+        if (free < wanted) {
+            cached_head = head.load(std::memory_order_acquire);
+            free = capacity() - (t - cached_head);
+        }
+        return free;
+    }
+
+    // Filled slots seen by the consumer, rereading tail only if the cached copy shows fewer than `wanted`
+    size_t filled_slots(size_t h, size_t wanted) {
+        size_t filled = cached_tail - h;
+        if (filled < wanted) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            filled = cached_tail - h;
+        }
+        return filled;
+    }
+
+public:
+    // Room for at least `capacity` items, rounded up to a power of two
+    explicit spsc_queue(size_t capacity) : mask(round_up_to_power_of_two(capacity) - 1), arr(new T[mask + 1]) {}
+
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    // Producer only: add an item, returning false if the queue is full
+    bool try_enqueue(T payload) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (free_slots(t, 1) == 0) {
+            return false;
+        }
+
+        arr[t & mask] = std::move(payload);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer only: add an item, waiting while the queue is full: spinning first, then yielding
+    void enqueue(T payload) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        for (int spins = 0; free_slots(t, 1) == 0; spins++) {
+            if (spins >= 64) std::this_thread::yield();
+        }
+
+        arr[t & mask] = std::move(payload);
+        tail.store(t + 1, std::memory_order_release);
+    }
+
+    // Producer only: add as many of the `count` items at `items` as fit, returning how many were added
+    size_t enqueue_n(const T* items, size_t count) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        count = std::min(count, free_slots(t, count));
+
+        // The span may wrap around the end of the array
+        size_t first = std::min(count, capacity() - (t & mask));
+        std::copy(items, items + first, &arr[t & mask]);
+        std::copy(items + first, items + count, &arr[0]);
+        tail.store(t + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer only: remove the oldest item into payload, returning false if the queue is empty
+    bool try_dequeue(T& payload) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (filled_slots(h, 1) == 0) {
+            return false;
+        }
+
+        payload = std::move(arr[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only: remove the oldest item, waiting while the queue is empty: spinning first, then yielding
+    T dequeue() {
+        size_t h = head.load(std::memory_order_relaxed);
+        for (int spins = 0; filled_slots(h, 1) == 0; spins++) {
+            if (spins >= 64) std::this_thread::yield();
+        }
+
+        T payload = std::move(arr[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return payload;
+    }
+
+    // Consumer only: remove up to `count` of the oldest items into `items`, returning how many were removed
+    size_t dequeue_n(T* items, size_t count) {
+        size_t h = head.load(std::memory_order_relaxed);
+        count = std::min(count, filled_slots(h, count));
+
+        size_t first = std::min(count, capacity() - (h & mask));
+        std::move(&arr[h & mask], &arr[h & mask] + first, items);
+        std::move(&arr[0], &arr[0] + (count - first), items + first);
+        head.store(h + count, std::memory_order_release);
+        return count;
+    }
+
+    // Number of items queued at some point during the call. head is read first: it can only have grown past
+    // a tail read earlier, never past a tail read later.
+    size_t size() const {
+        size_t h = head.load(std::memory_order_acquire);
+        return tail.load(std::memory_order_acquire) - h;
+    }
+
+    bool is_empty() const {
+        return size() == 0;
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+};
+
+#endif
@@ -0,0 +1,140 @@
+// Benchmark spsc_queue between a producer and a consumer thread pinned to two cores (0 and 1, or the first two
+// arguments; Linux only, and skipped when the machine has a single core).
+//   throughput   `n` 64-bit items (default 1 << 24, or the third argument) sent one at a time with
+//                try_enqueue and try_dequeue, then in batches of 64 and 1024 with enqueue_n and dequeue_n,
+//                through a queue of 4096 slots
+//   latency      100000 round trips of one item out through one queue and back through another; reported as
+//                the median and 99th percentile of half the round trip
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "spsc_queue.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+int cores[2] = { 0, 1 };
+bool pinned = false;
+
+// Pin the calling thread to cores[side]
+void pin(int side) {
+#ifdef __linux__
+    if (!pinned) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cores[side], &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void) side;
+#endif
+}
+
+// Retry `attempt` until it succeeds, spinning briefly and then yielding, so that threads sharing a core still
+// make progress
+template<typename Attempt>
+void retry(Attempt attempt) {
+    for (int spins = 0; !attempt(); spins++) {
+        if (spins >= 64) std::this_thread::yield();
+    }
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void throughput(uint64_t n, size_t batch_size) {
+    spsc_queue<uint64_t> q(4096);
+    uint64_t sum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&]() {
+        pin(0);
+        std::vector<uint64_t> batch(batch_size);
+        for (uint64_t next = 0; next < n;) {
+            if (batch_size == 1) {
+                retry([&]() { return q.try_enqueue(next); });
+                next++;
+            } else {
+                size_t count = std::min<uint64_t>(batch_size, n - next);
+                for (size_t i = 0; i < count; i++) batch[i] = next + i;
+                size_t added;
+                retry([&]() { return (added = q.enqueue_n(batch.data(), count)) > 0; });
+                next += added;
+            }
+        }
+    });
+    std::thread consumer([&]() {
+        pin(1);
+        std::vector<uint64_t> batch(batch_size);
+        uint64_t value;
+        for (uint64_t received = 0; received < n;) {
+            if (batch_size == 1) {
+                retry([&]() { return q.try_dequeue(value); });
+                sum += value;
+                received++;
+            } else {
+                size_t count;
+                retry([&]() { return (count = q.dequeue_n(batch.data(), batch_size)) > 0; });
+                for (size_t i = 0; i < count; i++) sum += batch[i];
+                received += count;
+            }
+        }
+    });
+    producer.join();
+    consumer.join();
+    double seconds = seconds_since(start);
+
+    printf("throughput, batches of %-5zu %10.1f M items/s   %s\n", batch_size, n / seconds / 1e6,
+           sum == n * (n - 1) / 2 ? "ok" : "WRONG SUM");
+}
+
+void latency(int round_trips) {
+    spsc_queue<uint64_t> out(64), back(64);
+    std::vector<double> nanoseconds(round_trips);
+
+    std::thread echo([&]() {
+        pin(1);
+        uint64_t value;
+        for (int i = 0; i < round_trips; i++) {
+            retry([&]() { return out.try_dequeue(value); });
+            retry([&]() { return back.try_enqueue(value); });
+        }
+    });
+    pin(0);
+    uint64_t value;
+    for (int i = 0; i < round_trips; i++) {
+        auto start = std::chrono::steady_clock::now();
+        retry([&]() { return out.try_enqueue(i); });
+        retry([&]() { return back.try_dequeue(value); });
+        nanoseconds[i] = seconds_since(start) * 1e9 / 2;
+    }
+    echo.join();
+
+    std::sort(nanoseconds.begin(), nanoseconds.end());
+    printf("latency, one way             %10.0f ns median, %.0f ns 99th percentile\n", nanoseconds[round_trips / 2],
+           nanoseconds[round_trips * 99 / 100]);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) cores[0] = atoi(argv[1]), cores[1] = atoi(argv[2]);
+    uint64_t n = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1 << 24;
+    pinned = std::thread::hardware_concurrency() > 1;
+    if (pinned) {
+        printf("producer on core %d, consumer on core %d\n", cores[0], cores[1]);
+    } else {
+        printf("single core: threads not pinned, and they time-share it\n");
+    }
+
+    throughput(n, 1);
+    throughput(n, 64);
+    throughput(n, 1024);
+    latency(100000);
+    return 0;
+}
@@ -1,55 +1,402 @@
 // Identify single-source shortest paths in a simple graph or detect a negative-weight cycle.
+//
+// The default engine is a FIFO-queue Bellman-Ford (SPFA) with Tarjan's subtree disassembly, which reports a
+// negative-weight cycle as soon as one closes. `--parallel` instead sweeps all edges in passes on every core,
+// stopping early once a pass makes no relaxation.
+//
+// After the source, the input may list batches of edge weight changes (a batch count, then per batch an update
+// count followed by "source dest weight" lines). Each batch is repaired incrementally and the results reprinted.
+// With `--graph <file>`, the graph comes from a binary file written by graph_convert and standard input starts
+// at the source. `--stats` reports queue operation and relaxation counts on standard error. `--reorder <order>`
+// renumbers the vertices for locality first (see graph_reorder.hpp); input and output still use the original IDs.
 
 #include <iostream>
-#include <unordered_set>
 #include <vector>
+#include <queue>
 #include <limits>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include "graph_file.hpp"
+#include "graph_reorder.hpp"
+#include "parallel.hpp"
 
 using namespace std;
 
 const int INF = numeric_limits<int>::max();
+const uint NONE = numeric_limits<uint>::max();
 
-struct Vertex {
-    uint id, pid;
+// Edges per chunk of a parallel Bellman-Ford pass; small graphs run each pass inline
+const size_t PASS_CHUNK_SIZE = 1 << 14;
+
+// Reverse adjacency pointing back into the forward CSR slots, so weight changes only touch one array
+struct InEdges {
+    vector<size_t> offsets, slots;
+    vector<uint> sources;
 };
 
-struct Edge {
-    uint source, dest;
-    int weight;
+InEdges build_in_edges(const csr_graph &graph) {
+    InEdges in_edges;
+    in_edges.offsets.assign(graph.num_vertices + 1, 0);
+    in_edges.slots.resize(graph.num_edges);
+    in_edges.sources.resize(graph.num_edges);
+
+    for (size_t slot = 0; slot < graph.num_edges; slot++) {
+        in_edges.offsets[graph.targets[slot] + 1]++;
+    }
+    for (uint i = 0; i < graph.num_vertices; i++) {
+        in_edges.offsets[i + 1] += in_edges.offsets[i];
+    }
+
+    vector<size_t> next(in_edges.offsets.begin(), in_edges.offsets.end() - 1);
+    for (uint source = 0; source < graph.num_vertices; source++) {
+        for (size_t slot = graph.offsets[source]; slot < graph.offsets[source + 1]; slot++) {
+            size_t position = next[graph.targets[slot]]++;
+            in_edges.slots[position] = slot;
+            in_edges.sources[position] = source;
+        }
+    }
+
+    return in_edges;
+}
+
+// Slot of edge (source, dest) in the forward CSR, or the edge count if there is no such edge
+size_t find_edge(const csr_graph &graph, uint source, uint dest) {
+    for (size_t slot = graph.offsets[source]; slot < graph.offsets[source + 1]; slot++) {
+        if (graph.targets[slot] == dest) {
+            return slot;
+        }
+    }
+    return graph.num_edges;
+}
+
+typedef tuple<uint, uint, int> WeightUpdate; // { source, dest, new weight }
+
+// Shortest-path tree kept as a doubly-linked list in preorder with depths, so the subtree of a vertex is the
+// run of vertices following it that are deeper than it.
+struct ShortestPathTree {
+    vector<int> distances;
+    vector<uint> parents;
+    vector<uint> next, prev, depth;
+    vector<bool> in_tree, in_queue;
+    queue<uint> frontier;
+    uint64_t queue_pushes = 0, queue_pops = 0, relaxations = 0; // reported with `--stats`
+
+    ShortestPathTree(uint vertices_count) : distances(vertices_count, INF), parents(vertices_count, NONE),
+        next(vertices_count, NONE), prev(vertices_count, NONE), depth(vertices_count, 0),
+        in_tree(vertices_count, false), in_queue(vertices_count, false) {}
+
+    // Rebuild the preorder list from parent links produced by another engine
+    void adopt(const vector<int> &labels, const vector<uint> &links, uint source) {
+        distances = labels;
+        parents = links;
+
+        uint vertices_count = distances.size();
+        vector<size_t> child_offsets(vertices_count + 1, 0);
+        vector<uint> children;
+        for (uint v = 0; v < vertices_count; v++) {
+            if (parents[v] != NONE && v != source) {
+                child_offsets[parents[v] + 1]++;
+            }
+        }
+        for (uint v = 0; v < vertices_count; v++) {
+            child_offsets[v + 1] += child_offsets[v];
+        }
+        children.resize(child_offsets[vertices_count]);
+        vector<size_t> slot(child_offsets.begin(), child_offsets.end() - 1);
+        for (uint v = 0; v < vertices_count; v++) {
+            if (parents[v] != NONE && v != source) {
+                children[slot[parents[v]]++] = v;
+            }
+        }
+
+        // Iterative preorder walk: a popped vertex is linked after the previous one and its children stacked
+        vector<uint> stack = { source };
+        uint last = NONE;
+        while (!stack.empty()) {
+            uint v = stack.back();
+            stack.pop_back();
+            prev[v] = last;
+            if (last != NONE) {
+                next[last] = v;
+            }
+            last = v;
+            in_tree[v] = true;
+            for (size_t i = child_offsets[v]; i < child_offsets[v + 1]; i++) {
+                depth[children[i]] = depth[v] + 1;
+                stack.push_back(children[i]);
+            }
+        }
+        next[last] = NONE;
+    }
+
+    void set_root(uint source) {
+        distances[source] = 0;
+        parents[source] = source;
+        in_tree[source] = true;
+        in_queue[source] = true;
+        frontier.push(source);
+        queue_pushes++;
+    }
+
+    // Remove `v` and its subtree from the tree; their labels are stale and will be rebuilt through `v`.
+    // Returns true if `u` is in the subtree, i.e. the edge (u, v) closes a negative-weight cycle.
+    bool disassemble(uint v, uint u) {
+        if (v == u) {
+            return true;
+        }
+
+        uint x = next[v];
+        while (x != NONE && depth[x] > depth[v]) {
+            if (x == u) {
+                return true;
+            }
+            in_tree[x] = false; // dropped from the queue lazily: skipped when popped unless reattached
+            x = next[x];
+        }
+
+        next[prev[v]] = x;
+        if (x != NONE) {
+            prev[x] = prev[v];
+        }
+        in_tree[v] = false;
+        return false;
+    }
+
+    // Attach `v` as the first child of `u`
+    void attach(uint v, uint u) {
+        next[v] = next[u];
+        if (next[u] != NONE) {
+            prev[next[u]] = v;
+        }
+        next[u] = v;
+        prev[v] = u;
+        depth[v] = depth[u] + 1;
+        in_tree[v] = true;
+    }
+
+    // Relax edge (u, v); returns false if doing so closes a negative-weight cycle through `v`
+    bool relax(uint u, uint v, int weight) {
+        if (distances[u] + weight >= distances[v]) {
+            return true;
+        }
+
+        if (in_tree[v] && disassemble(v, u)) {
+            parents[v] = u;
+            return false;
+        }
+
+        distances[v] = distances[u] + weight;
+        parents[v] = u;
+        attach(v, u);
+        relaxations++;
+        if (!in_queue[v]) {
+            in_queue[v] = true;
+            frontier.push(v);
+            queue_pushes++;
+        }
+        return true;
+    }
+
+    // Apply a batch of weight changes and repair the tree, touching only what the changes affect: subtrees below
+    // increased tree edges are cut off and rebuilt from their valid in-neighbours, and decreased edges are
+    // relaxed from their source. Returns a vertex on a negative-weight cycle, or NONE.
+    uint repair(csr_graph &graph, const InEdges &in_edges, const vector<WeightUpdate> &updates) {
+        vector<uint> increased_roots;
+        vector<pair<uint, size_t>> decreased; // { source, slot }
+        for (auto &[ source, dest, weight ] : updates) {
+            size_t slot = find_edge(graph, source, dest);
+            int old_weight = graph.weights[slot];
+            graph.weights[slot] = weight;
+
+            if (weight > old_weight && in_tree[dest] && parents[dest] == source && depth[dest] > 0) {
+                increased_roots.push_back(dest);
+            } else if (weight < old_weight) {
+                decreased.push_back({ source, slot });
+            }
+        }
+
+        // Cut each affected subtree out of the preorder list and forget its labels
+        vector<uint> invalidated;
+        for (uint root : increased_roots) {
+            if (!in_tree[root]) {
+                continue; // already inside another cut subtree
+            }
+            uint x = root;
+            do {
+                in_tree[x] = false;
+                distances[x] = INF;
+                parents[x] = NONE;
+                invalidated.push_back(x);
+                x = next[x];
+            } while (x != NONE && depth[x] > depth[root]);
+
+            next[prev[root]] = x;
+            if (x != NONE) {
+                prev[x] = prev[root];
+            }
+        }
+
+        // Reattach invalidated vertices below their best in-neighbour that is still in the tree
+        for (uint v : invalidated) {
+            uint best_parent = NONE;
+            for (size_t i = in_edges.offsets[v]; i < in_edges.offsets[v + 1]; i++) {
+                uint u = in_edges.sources[i];
+                if (in_tree[u] && distances[u] + graph.weights[in_edges.slots[i]] < distances[v]) {
+                    distances[v] = distances[u] + graph.weights[in_edges.slots[i]];
+                    best_parent = u;
+                }
+            }
+            if (best_parent != NONE) {
+                parents[v] = best_parent;
+                attach(v, best_parent);
+                if (!in_queue[v]) {
+                    in_queue[v] = true;
+                    frontier.push(v);
+                    queue_pushes++;
+                }
+            }
+        }
+
+        for (auto &[ u, slot ] : decreased) {
+            if (in_tree[u] && !relax(u, graph.targets[slot], graph.weights[slot])) {
+                return graph.targets[slot];
+            }
+        }
+
+        return run(graph);
+    }
+
+    // Process the queue until it empties; returns a vertex on a negative-weight cycle, or NONE
+    uint run(const csr_graph &graph) {
+        while (!frontier.empty()) {
+            uint u = frontier.front();
+            frontier.pop();
+            queue_pops++;
+            in_queue[u] = false;
+            if (!in_tree[u]) {
+                continue; // label became stale through disassembly
+            }
+
+            for (size_t i = graph.offsets[u]; i < graph.offsets[u + 1]; i++) {
+                if (!relax(u, graph.targets[i], graph.weights[i])) {
+                    return graph.targets[i];
+                }
+            }
+        }
+        return NONE;
+    }
 };
 
-void show_negative_weight_cycle(vector<Vertex>& vertices, uint id, unordered_set<uint>& seen, bool is_first = true) {
-    Vertex& vertex = vertices[id];
-    seen.insert(vertex.id);
+// A distance and parent packed into one word so both change together under an atomic min.
+// The distance is biased to unsigned in the high half, so comparing labels compares distances first.
+uint64_t pack_label(int distance, uint parent) {
+    return ((uint64_t) ((uint32_t) distance ^ 0x80000000u) << 32) | parent;
+}
+
+int label_distance(uint64_t label) {
+    return (int) ((uint32_t) (label >> 32) ^ 0x80000000u);
+}
+
+uint label_parent(uint64_t label) {
+    return (uint) label;
+}
 
-    if (!seen.count(vertex.pid)) {
-        show_negative_weight_cycle(vertices, vertex.pid, seen, false);
+// Bellman-Ford passes over a structure-of-arrays edge list, each pass split across threads that relax with an
+// atomic min. Returns false if edges still relax after |V| - 1 passes, i.e. a negative-weight cycle exists.
+// The CSR targets and weights already are two of the arrays; only the sources are expanded from the offsets.
+bool parallel_bellman_ford(const csr_graph &graph, uint source, vector<int> &distances, vector<uint> &parents,
+                           uint64_t &relaxations) {
+    uint vertices_count = graph.num_vertices;
+    size_t edges_count = graph.num_edges;
+    const uint *dests = graph.targets;
+    const int *weights = graph.weights;
+    vector<uint> sources(edges_count);
+    for (uint v = 0; v < vertices_count; v++) {
+        fill(sources.begin() + graph.offsets[v], sources.begin() + graph.offsets[v + 1], v);
     }
 
-    cout << vertex.id;
-    if (is_first) {
-        cout << endl;
-    } else {
-        cout << ", ";
+    vector<atomic<uint64_t>> labels(vertices_count);
+    for (uint i = 0; i < vertices_count; i++) {
+        labels[i].store(pack_label(INF, NONE), memory_order_relaxed);
+    }
+    labels[source].store(pack_label(0, source), memory_order_relaxed);
+
+    bool converged = false;
+    atomic<uint64_t> relaxation_count(0);
+    for (uint pass = 0; pass < vertices_count && !converged; pass++) {
+        atomic<bool> did_relax(false);
+
+        parallel_for(0, edges_count, PASS_CHUNK_SIZE, [&](unsigned, size_t begin, size_t end) {
+            uint64_t local_relaxations = 0;
+
+            for (size_t i = begin; i < end; i++) {
+                int source_distance = label_distance(labels[sources[i]].load(memory_order_relaxed));
+                if (source_distance == INF) {
+                    continue;
+                }
+
+                int candidate = source_distance + weights[i];
+                uint64_t desired = pack_label(candidate, sources[i]);
+                uint64_t current = labels[dests[i]].load(memory_order_relaxed);
+                while (label_distance(current) > candidate) {
+                    if (labels[dests[i]].compare_exchange_weak(current, desired, memory_order_relaxed)) {
+                        local_relaxations++;
+                        break;
+                    }
+                }
+            }
+
+            if (local_relaxations > 0) {
+                did_relax.store(true, memory_order_relaxed);
+                relaxation_count.fetch_add(local_relaxations, memory_order_relaxed);
+            }
+        });
+
+        // Early exit: a pass without any relaxation means every label is final
+        converged = !did_relax.load();
+    }
+
+    for (uint i = 0; i < vertices_count; i++) {
+        uint64_t label = labels[i].load(memory_order_relaxed);
+        distances[i] = label_distance(label);
+        parents[i] = label_parent(label);
+    }
+    relaxations = relaxation_count.load();
+
+    return converged;
+}
+
+// Print the cycle through `id` in edge order by walking parent links until they come back around
+void show_negative_weight_cycle(const vector<uint> &parents, const vertex_order &order, uint id) {
+    vector<uint> cycle = { id };
+    for (uint v = parents[id]; v != id; v = parents[v]) {
+        cycle.push_back(v);
+    }
+
+    for (size_t i = cycle.size() - 1; i > 0; i--) {
+        cout << order.to_original(cycle[i]) << ", ";
     }
+    cout << order.to_original(cycle[0]) << endl;
 }
 
-void show_single_source_shortest_paths(vector<int>& distances) {
+void show_single_source_shortest_paths(vector<int>& distances, const vertex_order &order) {
     for (uint i = 0; i < distances.size(); i++) {
-        cout << i << ": " << (distances[i] == INF ? "unreachable" : to_string(distances[i])) << endl;
+        int distance = distances[order.to_new(i)];
+        cout << i << ": " << (distance == INF ? "unreachable" : to_string(distance)) << endl;
     }
 }
 
-int main() {
-    vector<Vertex> vertices;
-    vector<Edge> edges;
+// Read the graph's edges from standard input
+csr_graph read_graph() {
+    vector<graph_edge> edges;
 
     // Initialise vertices
     uint vertices_count;
     cin >> vertices_count;
-    for (uint i = 0; i < vertices_count; i++) {
-        vertices.push_back(Vertex { i, i });
-    }
 
     // Initialise edges
     uint edges_count;
@@ -62,50 +409,121 @@ int main() {
         // Check vertices are valid
         if (src >= vertices_count || dest >= vertices_count) {
             cout << "Input vertex not found in graph." << endl;
+            exit(1);
+        }
+
+        edges.push_back(graph_edge{ src, dest, weight });
+    }
+
+    return csr_graph::from_edges(vertices_count, edges, true);
+}
+
+int main(int argc, char *argv[]) {
+    bool parallel = false, stats = false, valid_arguments = true;
+    const char *graph_file = nullptr, *reorder = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--parallel") == 0) {
+            parallel = true;
+        } else if (strcmp(argv[i], "--graph") == 0 && i + 1 < argc) {
+            graph_file = argv[++i];
+        } else if (strcmp(argv[i], "--reorder") == 0 && i + 1 < argc) {
+            reorder = argv[++i];
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else {
+            valid_arguments = false;
+        }
+    }
+    if (!valid_arguments) {
+        cout << "Invalid Arguments." << " Usage: bellman_ford [--parallel] [--graph <file>]"
+             << " [--reorder <rcm|bfs|degree|hub>] [--stats]" << endl;
+        return 1;
+    }
+
+    // Map the graph file if one is given; weight updates then copy only the pages they touch
+    csr_graph graph;
+    if (graph_file) {
+        if (!graph.load(graph_file) || !graph.weighted()) {
+            cout << "Could not load weighted graph from " << graph_file << "." << endl;
             return 1;
         }
+    } else {
+        graph = read_graph();
+    }
+    uint vertices_count = graph.num_vertices;
 
-        edges.push_back(Edge{ src, dest, weight });
+    vertex_order order;
+    if (reorder && !reorder_graph(graph, reorder, order)) {
+        cout << "Unknown vertex order " << reorder << "." << endl;
+        return 1;
     }
 
     // Get source vertex
     uint source;
-    cin >> source;
+    if (!(cin >> source) || source >= vertices_count) {
+        cout << "Input vertex not found in graph." << endl;
+        return 1;
+    }
+    source = order.to_new(source);
 
-    // Initialise known distances to infinity
-    vector<int> distances(vertices_count, INF);
+    ShortestPathTree tree(vertices_count);
+    uint witness_vertex_id = NONE; // `NONE` indicates no negative-weight cycle found
 
-    // Set distance to source to 0
-    distances[source] = 0;
+    vector<int> distances(vertices_count, INF);
+    vector<uint> parents(vertices_count, NONE);
+    uint64_t parallel_relaxations = 0;
+    if (parallel && parallel_bellman_ford(graph, source, distances, parents, parallel_relaxations)) {
+        // Converged within |V| - 1 passes, so no negative-weight cycle is reachable
+        tree.adopt(distances, parents, source);
+    } else {
+        // The queue engine either is the chosen one or pinpoints the cycle the parallel passes detected
+        tree.set_root(source);
+        witness_vertex_id = tree.run(graph);
+    }
 
-    // Relax edges |V| - 1 times (|V| being count of vertices)
-    for (uint i = 0; i < vertices_count - 1; i++) {
-        for (Edge& edge : edges) {
-            if (distances[edge.source] + edge.weight < distances[edge.dest]) {
-                distances[edge.dest] = distances[edge.source] + edge.weight;
-                vertices[edge.dest].pid = edge.source;
+    // Repair the results after each batch of weight changes instead of recomputing them
+    uint num_batches = 0;
+    InEdges in_edges;
+    if (witness_vertex_id == NONE && cin >> num_batches) {
+        in_edges = build_in_edges(graph);
+    }
+    for (uint batch = 0; batch <= num_batches; batch++) {
+        if (batch > 0) {
+            uint num_updates;
+            cin >> num_updates;
+            vector<WeightUpdate> updates(num_updates);
+            for (auto &[ src, dest, weight ] : updates) {
+                cin >> src >> dest >> weight;
+                if (src >= vertices_count || dest >= vertices_count) {
+                    cout << "Edge not found in graph." << endl;
+                    return 1;
+                }
+                src = order.to_new(src);
+                dest = order.to_new(dest);
+                if (find_edge(graph, src, dest) == graph.num_edges) {
+                    cout << "Edge not found in graph." << endl;
+                    return 1;
+                }
             }
+
+            witness_vertex_id = tree.repair(graph, in_edges, updates);
+            cout << "After update batch " << batch << ":" << endl;
         }
-    }
 
-    // Check if a negative-weight cycle exists using another round of relaxation
-    uint witness_vertex_id = vertices_count; // `vertices_count` value indicates no witness found
-    for (Edge& edge : edges) {
-        if (distances[edge.source] + edge.weight < distances[edge.dest]) {
-            vertices[edge.dest].pid = edge.source;
-            witness_vertex_id = edge.dest;
+        if (witness_vertex_id == NONE) {
+            // No negative-edge cycle found, print single-source shortest paths
+            // Just printing the distances in this example, but can print paths because we have all parents
+            show_single_source_shortest_paths(tree.distances, order);
+        } else {
+            // Negative-edge cycle found, print the cycle
+            show_negative_weight_cycle(tree.parents, order, witness_vertex_id);
             break;
         }
     }
 
-    if (witness_vertex_id == vertices_count) {
-        // No negative-edge cycle found, print single-source shortest paths
-        // Just printing the distances in this example, but can print paths because we have all parents
-        show_single_source_shortest_paths(distances);
-    } else {
-        // Negative-edge cycle found, print the cycle
-        unordered_set<uint> seen;
-        show_negative_weight_cycle(vertices, witness_vertex_id, seen);
+    if (stats) {
+        cerr << "stats: queue_pushes=" << tree.queue_pushes << " queue_pops=" << tree.queue_pops
+             << " relaxations=" << tree.relaxations + parallel_relaxations << endl;
     }
 
     return 0;
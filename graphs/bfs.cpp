@@ -0,0 +1,242 @@
+// Find hop distances and a shortest path tree from a source vertex in an unweighted directed graph.
+//
+// Runs a level-synchronous, direction-optimizing breadth-first search (Beamer et al.). While the frontier is
+// small, each level expands it top-down: threads scan the out-edges of frontier vertices and claim unvisited
+// ones with a compare-and-swap on their parent. Once the frontier's edges outnumber a fraction of those still
+// unexplored, levels run bottom-up instead: every unvisited vertex scans its in-edges for a parent in the
+// frontier, which is held as a bitmap, and stops at the first one found. The search switches back to top-down
+// when the frontier shrinks again. On small-diameter graphs most edges are then never looked at.
+//
+// Input is "V E" followed by E "source dest" lines and then the source vertex, or with `--graph <file>` a
+// binary graph written by graph_convert or graph_generator (weights are ignored) and then the source.
+// `--reorder <order>` renumbers the vertices for locality first (see graph_reorder.hpp); input and output
+// still use the original IDs. `--stats` reports level and edge counts on standard error.
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include "graph_file.hpp"
+#include "graph_reorder.hpp"
+#include "parallel.hpp"
+
+using namespace std;
+
+const uint32_t NONE = numeric_limits<uint32_t>::max();
+
+// Direction switching thresholds from Beamer et al.: go bottom-up once the frontier has more than 1/ALPHA of
+// the unexplored edges, and back top-down once it holds fewer than 1/BETA of the vertices and is shrinking
+const uint64_t ALPHA = 14, BETA = 24;
+
+struct SearchStats {
+    uint32_t top_down_levels = 0, bottom_up_levels = 0;
+    uint64_t edges_examined = 0;
+};
+
+class BreadthFirstSearch {
+public:
+    vector<atomic<uint32_t>> parents;
+    vector<uint32_t> hops;
+    SearchStats stats;
+
+    BreadthFirstSearch(csr_graph &graph) : parents(graph.num_vertices), hops(graph.num_vertices, NONE), graph(graph),
+                                           frontier_bits((graph.num_vertices + 63) / 64), local_frontiers(thread_count()) {
+        graph.build_transpose();
+        for (atomic<uint32_t> &parent : parents) {
+            parent.store(NONE, memory_order_relaxed);
+        }
+    }
+
+    void run(uint32_t source) {
+        parents[source].store(source, memory_order_relaxed);
+        hops[source] = 0;
+        frontier = { source };
+
+        uint64_t frontier_edges = graph.out_degree(source), unexplored_edges = graph.num_edges - frontier_edges;
+        bool bottom_up = false;
+        for (uint32_t level = 0; !frontier.empty(); level++) {
+            uint64_t frontier_size = frontier.size();
+            if (!bottom_up && frontier_edges > unexplored_edges / ALPHA) {
+                bottom_up = true;
+            } else if (bottom_up && frontier_size < graph.num_vertices / BETA && frontier_size < previous_size) {
+                bottom_up = false;
+            }
+            previous_size = frontier_size;
+
+            if (bottom_up) {
+                stats.bottom_up_levels++;
+                bottom_up_step(level);
+            } else {
+                stats.top_down_levels++;
+                top_down_step(level);
+            }
+
+            frontier_edges = 0;
+            for (uint32_t v : frontier) {
+                frontier_edges += graph.out_degree(v);
+            }
+            unexplored_edges -= min(unexplored_edges, frontier_edges);
+        }
+    }
+
+private:
+    csr_graph &graph;
+    vector<uint32_t> frontier;
+    vector<uint64_t> frontier_bits;
+    vector<vector<uint32_t>> local_frontiers;
+    uint64_t previous_size = 0;
+
+    // Expand the frontier along out-edges; each vertex goes to whichever thread claims its parent first
+    void top_down_step(uint32_t level) {
+        atomic<uint64_t> examined(0);
+        parallel_for(0, frontier.size(), 256, [&](unsigned thread_id, size_t from, size_t to) {
+            vector<uint32_t> &discovered = local_frontiers[thread_id];
+            uint64_t local_examined = 0;
+            for (size_t i = from; i < to; i++) {
+                uint32_t u = frontier[i];
+                local_examined += graph.out_degree(u);
+                for (uint64_t e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+                    uint32_t v = graph.targets[e], unclaimed = NONE;
+                    if (parents[v].load(memory_order_relaxed) == NONE &&
+                        parents[v].compare_exchange_strong(unclaimed, u, memory_order_relaxed)) {
+                        hops[v] = level + 1;
+                        discovered.push_back(v);
+                    }
+                }
+            }
+            examined.fetch_add(local_examined, memory_order_relaxed);
+        });
+        stats.edges_examined += examined;
+
+        frontier.clear();
+        for (vector<uint32_t> &discovered : local_frontiers) {
+            frontier.insert(frontier.end(), discovered.begin(), discovered.end());
+            discovered.clear();
+        }
+    }
+
+    // Every unvisited vertex looks for a parent among its in-neighbours in the frontier bitmap and stops at the
+    // first one; each vertex is only ever written by the thread that owns its chunk
+    void bottom_up_step(uint32_t level) {
+        fill(frontier_bits.begin(), frontier_bits.end(), 0);
+        for (uint32_t v : frontier) {
+            frontier_bits[v / 64] |= 1ull << (v % 64);
+        }
+
+        atomic<uint64_t> examined(0);
+        parallel_for(0, graph.num_vertices, 4096, [&](unsigned thread_id, size_t from, size_t to) {
+            vector<uint32_t> &discovered = local_frontiers[thread_id];
+            uint64_t local_examined = 0;
+            for (uint32_t v = from; v < to; v++) {
+                if (parents[v].load(memory_order_relaxed) != NONE) {
+                    continue;
+                }
+                for (uint64_t e = graph.in_offsets[v]; e < graph.in_offsets[v + 1]; e++) {
+                    uint32_t u = graph.in_sources[e];
+                    local_examined++;
+                    if (frontier_bits[u / 64] >> (u % 64) & 1) {
+                        parents[v].store(u, memory_order_relaxed);
+                        hops[v] = level + 1;
+                        discovered.push_back(v);
+                        break;
+                    }
+                }
+            }
+            examined.fetch_add(local_examined, memory_order_relaxed);
+        });
+        stats.edges_examined += examined;
+
+        frontier.clear();
+        for (vector<uint32_t> &discovered : local_frontiers) {
+            frontier.insert(frontier.end(), discovered.begin(), discovered.end());
+            discovered.clear();
+        }
+    }
+};
+
+// Read "V E" and E "source dest" lines from standard input; false if a vertex is out of range
+bool read_graph(csr_graph &graph) {
+    uint32_t num_vertices;
+    size_t num_edges;
+    cin >> num_vertices >> num_edges;
+    vector<graph_edge> edges(num_edges);
+    for (graph_edge &edge : edges) {
+        cin >> edge.source >> edge.dest;
+        if (!cin || edge.source >= num_vertices || edge.dest >= num_vertices) {
+            return false;
+        }
+    }
+    graph = csr_graph::from_edges(num_vertices, edges, false);
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    const char *graph_file = nullptr, *reorder = nullptr;
+    bool stats = false, valid_arguments = true;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--graph") == 0 && i + 1 < argc) {
+            graph_file = argv[++i];
+        } else if (strcmp(argv[i], "--reorder") == 0 && i + 1 < argc) {
+            reorder = argv[++i];
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else {
+            valid_arguments = false;
+        }
+    }
+    if (!valid_arguments) {
+        cout << "Invalid Arguments." << " Usage: bfs [--graph <file>] [--reorder <rcm|bfs|degree|hub>] [--stats]" << endl;
+        return 1;
+    }
+
+    csr_graph graph;
+    if (graph_file) {
+        if (!graph.load(graph_file)) {
+            cout << "Could not load graph from " << graph_file << "." << endl;
+            return 1;
+        }
+    } else if (!read_graph(graph)) {
+        cout << "Input vertex not found in graph." << endl;
+        return 1;
+    }
+
+    vertex_order order;
+    if (reorder && !reorder_graph(graph, reorder, order)) {
+        cout << "Unknown vertex order " << reorder << "." << endl;
+        return 1;
+    }
+
+    uint32_t source;
+    if (!(cin >> source) || source >= graph.num_vertices) {
+        cout << "Input vertex not found in graph." << endl;
+        return 1;
+    }
+
+    BreadthFirstSearch search(graph);
+    search.run(order.to_new(source));
+
+    // Print results to standard output
+    string out = "Breadth-First Search Tree:\n";
+    for (uint32_t id = 0; id < graph.num_vertices; id++) {
+        uint32_t v = order.to_new(id), parent = search.parents[v].load(memory_order_relaxed);
+        out += "ID: " + to_string(id) + "\tParent ID: " + (parent == NONE ? "NONE" : to_string(order.to_original(parent))) +
+               "\tHops: " + (search.hops[v] == NONE ? "INF" : to_string(search.hops[v])) + "\n";
+        if (out.size() >= (1 << 16)) {
+            fwrite(out.data(), 1, out.size(), stdout);
+            out.clear();
+        }
+    }
+    fwrite(out.data(), 1, out.size(), stdout);
+
+    if (stats) {
+        cerr << "stats: top_down_levels=" << search.stats.top_down_levels << " bottom_up_levels="
+             << search.stats.bottom_up_levels << " edges_examined=" << search.stats.edges_examined << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,512 @@
+// Answer point-to-point shortest path queries on a static directional graph with only non-negative edges
+// using contraction hierarchies. The hierarchy is built once, written to disk and memory-mapped by queries.
+//
+// Usage:
+//   contraction_hierarchies build [--graph <file>] <hierarchy_file>
+//       (reads a graph in the same format as dijkstra.cpp, or maps the graph_file.hpp file given with --graph)
+//   contraction_hierarchies query <hierarchy_file>   (reads a query count followed by "source dest" pairs)
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "graph_file.hpp"
+
+using namespace std;
+
+uint INF = numeric_limits<uint>::max();
+
+// Stop a witness search after settling this many vertices; a missed witness only costs an extra shortcut.
+const uint WITNESS_SETTLE_LIMIT = 500;
+
+struct Arc {
+    uint head, weight;
+    uint middle; // contracted vertex bridged by a shortcut, INF for original edges
+};
+
+// On-disk layout: header, up offsets, up arcs, down offsets, down arcs (each section 8-byte aligned).
+// Up arcs of v lead to higher-ranked heads, down arcs of v are edges into v from higher-ranked tails.
+struct HierarchyHeader {
+    char magic[8];
+    uint64_t num_vertices, num_up_arcs, num_down_arcs;
+};
+
+const char HIERARCHY_MAGIC[8] = { 'C', 'H', 'G', 'R', 'A', 'P', 'H', '1' };
+
+struct Hierarchy {
+    uint num_vertices;
+    const uint64_t *up_offsets, *down_offsets;
+    const Arc *up_arcs, *down_arcs;
+};
+
+struct Contractor {
+    uint num_vertices;
+    vector<vector<Arc>> out_arcs, in_arcs; // arcs between vertices that are not yet contracted
+    vector<vector<Arc>> up, down;
+    vector<bool> contracted;
+    vector<uint> contracted_neighbours;
+
+    // Scratch space for witness searches, reset through `touched` to keep each search local
+    vector<uint> witness_dist;
+    vector<uint> touched;
+
+    Contractor(uint n) : num_vertices(n), out_arcs(n), in_arcs(n), up(n), down(n), contracted(n, false),
+                         contracted_neighbours(n, 0), witness_dist(n, INF) {}
+
+    // Keep only the lightest arc between a pair of vertices
+    void add_arc(uint tail, uint head, uint weight, uint middle) {
+        for (Arc &arc : out_arcs[tail]) {
+            if (arc.head == head) {
+                if (weight < arc.weight) {
+                    arc = { head, weight, middle };
+                    for (Arc &in_arc : in_arcs[head]) {
+                        if (in_arc.head == tail) {
+                            in_arc = { tail, weight, middle };
+                        }
+                    }
+                }
+                return;
+            }
+        }
+        out_arcs[tail].push_back({ head, weight, middle });
+        in_arcs[head].push_back({ tail, weight, middle });
+    }
+
+    // Local Dijkstra from `source` over uncontracted vertices, never passing through `excluded`
+    void witness_search(uint source, uint excluded, uint limit) {
+        for (uint id : touched) {
+            witness_dist[id] = INF;
+        }
+        touched.clear();
+
+        priority_queue<pair<uint, uint>, vector<pair<uint, uint>>, greater<pair<uint, uint>>> q;
+        witness_dist[source] = 0;
+        touched.push_back(source);
+        q.push({ 0, source });
+
+        uint settled = 0;
+        while (!q.empty() && settled < WITNESS_SETTLE_LIMIT) {
+            auto [ dist, id ] = q.top();
+            q.pop();
+            if (dist > witness_dist[id]) {
+                continue;
+            }
+            if (dist > limit) {
+                break;
+            }
+            settled++;
+            for (const Arc &arc : out_arcs[id]) {
+                if (arc.head == excluded || contracted[arc.head]) {
+                    continue;
+                }
+                if (witness_dist[arc.head] > dist + arc.weight) {
+                    if (witness_dist[arc.head] == INF) {
+                        touched.push_back(arc.head);
+                    }
+                    witness_dist[arc.head] = dist + arc.weight;
+                    q.push({ witness_dist[arc.head], arc.head });
+                }
+            }
+        }
+    }
+
+    // Find the shortcuts needed to contract `v`; only counts them unless `insert` is set
+    uint contract(uint v, bool insert) {
+        uint max_out = 0;
+        for (const Arc &out : out_arcs[v]) {
+            max_out = max(max_out, out.weight);
+        }
+
+        vector<Arc> shortcuts; // { tail (stored in middle), head, weight }
+        for (const Arc &in : in_arcs[v]) {
+            uint u = in.head;
+            witness_search(u, v, in.weight + max_out);
+            for (const Arc &out : out_arcs[v]) {
+                if (out.head == u) {
+                    continue;
+                }
+                if (witness_dist[out.head] > in.weight + out.weight) {
+                    shortcuts.push_back({ out.head, in.weight + out.weight, u });
+                }
+            }
+        }
+
+        if (insert) {
+            for (const Arc &shortcut : shortcuts) {
+                add_arc(shortcut.middle, shortcut.head, shortcut.weight, v);
+            }
+        }
+        return shortcuts.size();
+    }
+
+    // Edge difference plus a penalty that spreads contraction evenly over the graph
+    int priority(uint v) {
+        int edge_difference = (int) contract(v, false) - (int) (in_arcs[v].size() + out_arcs[v].size());
+        return edge_difference + (int) contracted_neighbours[v];
+    }
+
+    void run() {
+        priority_queue<pair<int, uint>, vector<pair<int, uint>>, greater<pair<int, uint>>> order;
+        for (uint v = 0; v < num_vertices; v++) {
+            order.push({ priority(v), v });
+        }
+
+        while (!order.empty()) {
+            uint v = order.top().second;
+            order.pop();
+
+            // Lazy update: recompute the priority and postpone the vertex if it is no longer the minimum
+            int updated = priority(v);
+            if (!order.empty() && updated > order.top().first) {
+                order.push({ updated, v });
+                continue;
+            }
+
+            // Remaining arcs of `v` lead to higher-ranked vertices and become part of the hierarchy
+            up[v] = out_arcs[v];
+            down[v] = in_arcs[v];
+            contract(v, true);
+            contracted[v] = true;
+
+            for (const Arc &out : out_arcs[v]) {
+                auto &arcs = in_arcs[out.head];
+                arcs.erase(remove_if(arcs.begin(), arcs.end(), [v](const Arc &arc) { return arc.head == v; }), arcs.end());
+                contracted_neighbours[out.head]++;
+            }
+            for (const Arc &in : in_arcs[v]) {
+                auto &arcs = out_arcs[in.head];
+                arcs.erase(remove_if(arcs.begin(), arcs.end(), [v](const Arc &arc) { return arc.head == v; }), arcs.end());
+                contracted_neighbours[in.head]++;
+            }
+            out_arcs[v].clear();
+            in_arcs[v].clear();
+        }
+    }
+};
+
+void write_section(ofstream &file, const vector<vector<Arc>> &arcs) {
+    uint64_t offset = 0;
+    file.write((const char *) &offset, sizeof(offset));
+    for (const auto &list : arcs) {
+        offset += list.size();
+        file.write((const char *) &offset, sizeof(offset));
+    }
+    for (const auto &list : arcs) {
+        file.write((const char *) list.data(), list.size() * sizeof(Arc));
+    }
+
+    // Pad so the next section stays 8-byte aligned
+    uint64_t padding = 0;
+    file.write((const char *) &padding, (8 - offset * sizeof(Arc) % 8) % 8);
+}
+
+bool write_hierarchy(const char *path, const Contractor &contractor) {
+    ofstream file(path, ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    HierarchyHeader header;
+    memcpy(header.magic, HIERARCHY_MAGIC, sizeof(header.magic));
+    header.num_vertices = contractor.num_vertices;
+    header.num_up_arcs = header.num_down_arcs = 0;
+    for (uint v = 0; v < contractor.num_vertices; v++) {
+        header.num_up_arcs += contractor.up[v].size();
+        header.num_down_arcs += contractor.down[v].size();
+    }
+
+    file.write((const char *) &header, sizeof(header));
+    write_section(file, contractor.up);
+    write_section(file, contractor.down);
+    return (bool) file;
+}
+
+// Map the hierarchy file read-only so queries start without parsing and share the page cache
+bool map_hierarchy(const char *path, Hierarchy &hierarchy) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) < 0 || (size_t) info.st_size < sizeof(HierarchyHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void *data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    const char *cursor = (const char *) data;
+    const HierarchyHeader *header = (const HierarchyHeader *) cursor;
+    if (memcmp(header->magic, HIERARCHY_MAGIC, sizeof(header->magic)) != 0) {
+        munmap(data, info.st_size);
+        return false;
+    }
+    cursor += sizeof(HierarchyHeader);
+
+    hierarchy.num_vertices = header->num_vertices;
+    hierarchy.up_offsets = (const uint64_t *) cursor;
+    cursor += (header->num_vertices + 1) * sizeof(uint64_t);
+    hierarchy.up_arcs = (const Arc *) cursor;
+    cursor += (header->num_up_arcs * sizeof(Arc) + 7) / 8 * 8;
+    hierarchy.down_offsets = (const uint64_t *) cursor;
+    cursor += (header->num_vertices + 1) * sizeof(uint64_t);
+    hierarchy.down_arcs = (const Arc *) cursor;
+    cursor += (header->num_down_arcs * sizeof(Arc) + 7) / 8 * 8;
+
+    if (cursor - (const char *) data > info.st_size) {
+        munmap(data, info.st_size);
+        return false;
+    }
+    return true;
+}
+
+// One direction of the bidirectional search; both directions only ever move up the hierarchy
+struct Search {
+    vector<uint> dist, parent, parent_middle;
+    vector<uint> touched;
+    priority_queue<pair<uint, uint>, vector<pair<uint, uint>>, greater<pair<uint, uint>>> q;
+
+    Search(uint n) : dist(n, INF), parent(n, INF), parent_middle(n, INF) {}
+
+    void reset(uint source) {
+        for (uint id : touched) {
+            dist[id] = parent[id] = parent_middle[id] = INF;
+        }
+        touched.clear();
+        q = {};
+        dist[source] = 0;
+        parent[source] = source;
+        touched.push_back(source);
+        q.push({ 0, source });
+    }
+
+    // Settle the next vertex, relaxing `forward` arcs unless a `stall` arc proves its label is not optimal
+    void step(const uint64_t *forward_offsets, const Arc *forward, const uint64_t *stall_offsets, const Arc *stall,
+              const Search &other, uint &best, uint &meeting) {
+        auto [ d, id ] = q.top();
+        q.pop();
+        if (d > dist[id]) {
+            return;
+        }
+
+        if (other.dist[id] != INF && d + other.dist[id] < best) {
+            best = d + other.dist[id];
+            meeting = id;
+        }
+
+        // Stall-on-demand: a higher-ranked vertex already reaches `id` more cheaply
+        for (uint64_t i = stall_offsets[id]; i < stall_offsets[id + 1]; i++) {
+            if (dist[stall[i].head] != INF && dist[stall[i].head] + stall[i].weight < d) {
+                return;
+            }
+        }
+
+        for (uint64_t i = forward_offsets[id]; i < forward_offsets[id + 1]; i++) {
+            const Arc &arc = forward[i];
+            if (dist[arc.head] > d + arc.weight) {
+                if (dist[arc.head] == INF) {
+                    touched.push_back(arc.head);
+                }
+                dist[arc.head] = d + arc.weight;
+                parent[arc.head] = id;
+                parent_middle[arc.head] = arc.middle;
+                q.push({ dist[arc.head], arc.head });
+            }
+        }
+    }
+};
+
+// Expand the shortcut `tail -> head` (bridging `middle`) into original vertices, excluding `tail`
+void unpack(const Hierarchy &h, uint tail, uint head, uint middle, vector<uint> &path) {
+    vector<pair<pair<uint, uint>, uint>> pending = { { { tail, head }, middle } };
+    while (!pending.empty()) {
+        auto [ arc, via ] = pending.back();
+        pending.pop_back();
+        if (via == INF) {
+            path.push_back(arc.second);
+            continue;
+        }
+        // Push the second half first so the first half is expanded first
+        uint second_middle = INF, first_middle = INF;
+        for (uint64_t i = h.up_offsets[via]; i < h.up_offsets[via + 1]; i++) {
+            if (h.up_arcs[i].head == arc.second) {
+                second_middle = h.up_arcs[i].middle;
+            }
+        }
+        for (uint64_t i = h.down_offsets[via]; i < h.down_offsets[via + 1]; i++) {
+            if (h.down_arcs[i].head == arc.first) {
+                first_middle = h.down_arcs[i].middle;
+            }
+        }
+        pending.push_back({ { via, arc.second }, second_middle });
+        pending.push_back({ { arc.first, via }, first_middle });
+    }
+}
+
+int build(const char *path, const char *graph_file) {
+    csr_graph graph;
+    if (graph_file) {
+        if (!graph.load(graph_file) || !graph.weighted()) {
+            cout << "Could not load weighted graph from " << graph_file << "." << endl;
+            return 1;
+        }
+    } else {
+        uint num_vertices, num_edges;
+        cin >> num_vertices >> num_edges;
+
+        vector<graph_edge> edges(num_edges);
+        for (graph_edge &edge : edges) {
+            cin >> edge.source >> edge.dest >> edge.weight;
+            if (edge.source >= num_vertices || edge.dest >= num_vertices) {
+                cout << "Input vertex not found in graph." << endl;
+                return 1;
+            }
+        }
+        graph = csr_graph::from_edges(num_vertices, edges, true);
+    }
+
+    uint num_vertices = graph.num_vertices;
+    Contractor contractor(num_vertices);
+    for (uint source_id = 0; source_id < num_vertices; source_id++) {
+        for (uint64_t e = graph.offsets[source_id]; e < graph.offsets[source_id + 1]; e++) {
+            if (graph.weights[e] < 0) {
+                cout << "Edge weights must be non-negative." << endl;
+                return 1;
+            }
+            if (graph.targets[e] != source_id) {
+                contractor.add_arc(source_id, graph.targets[e], graph.weights[e], INF);
+            }
+        }
+    }
+
+    contractor.run();
+
+    if (!write_hierarchy(path, contractor)) {
+        cout << "Could not write hierarchy to " << path << endl;
+        return 1;
+    }
+
+    uint64_t num_arcs = 0;
+    for (uint v = 0; v < num_vertices; v++) {
+        num_arcs += contractor.up[v].size() + contractor.down[v].size();
+    }
+    cout << "Contracted " << num_vertices << " vertices into " << num_arcs << " hierarchy arcs." << endl;
+    return 0;
+}
+
+int query(const char *path) {
+    Hierarchy h;
+    if (!map_hierarchy(path, h)) {
+        cout << "Could not load hierarchy from " << path << endl;
+        return 1;
+    }
+
+    Search forward(h.num_vertices), backward(h.num_vertices);
+
+    uint num_queries;
+    cin >> num_queries;
+    for (uint i = 0; i < num_queries; i++) {
+        uint source_id, dest_id;
+        cin >> source_id >> dest_id;
+        if (source_id >= h.num_vertices || dest_id >= h.num_vertices) {
+            cout << "Input vertex not found in graph." << endl;
+            return 1;
+        }
+
+        // Alternate directions until neither frontier can improve on the best meeting point
+        uint best = INF, meeting = INF;
+        forward.reset(source_id);
+        backward.reset(dest_id);
+        while ((!forward.q.empty() && forward.q.top().first < best) || (!backward.q.empty() && backward.q.top().first < best)) {
+            if (!forward.q.empty() && forward.q.top().first < best) {
+                forward.step(h.up_offsets, h.up_arcs, h.down_offsets, h.down_arcs, backward, best, meeting);
+            }
+            if (!backward.q.empty() && backward.q.top().first < best) {
+                backward.step(h.down_offsets, h.down_arcs, h.up_offsets, h.up_arcs, forward, best, meeting);
+            }
+        }
+
+        cout << "From " << source_id << " to " << dest_id << ":\tDistance: ";
+        if (best == INF) {
+            cout << "INF\n";
+            continue;
+        }
+        cout << best << "\tPath: " << source_id;
+
+        // Walk the forward search tree back to the source, then the backward tree on to the destination
+        vector<uint> up_chain;
+        for (uint id = meeting; id != source_id; id = forward.parent[id]) {
+            up_chain.push_back(id);
+        }
+        vector<uint> path;
+        uint tail = source_id;
+        for (auto it = up_chain.rbegin(); it != up_chain.rend(); it++) {
+            unpack(h, tail, *it, forward.parent_middle[*it], path);
+            tail = *it;
+        }
+        for (uint id = meeting; id != dest_id; id = backward.parent[id]) {
+            unpack(h, id, backward.parent[id], backward.parent_middle[id], path);
+        }
+        for (uint id : path) {
+            cout << " " << id;
+        }
+        cout << "\n";
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    bool building = argc > 1 && strcmp(argv[1], "build") == 0;
+    bool valid_arguments = building || (argc > 1 && strcmp(argv[1], "query") == 0);
+    const char *graph_file = nullptr, *path = nullptr;
+    for (int i = 2; i < argc && valid_arguments; i++) {
+        if (building && strcmp(argv[i], "--graph") == 0 && i + 1 < argc) {
+            graph_file = argv[++i];
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            valid_arguments = false;
+        }
+    }
+    if (!valid_arguments || !path) {
+        cout << "Invalid Arguments." << " Usage: contraction_hierarchies build [--graph <file>] <hierarchy_file>"
+             << " | contraction_hierarchies query <hierarchy_file>" << endl;
+        return 1;
+    }
+
+    return building ? build(path, graph_file) : query(path);
+}
+
+/*
+Sample Test Case (build input):
+6 9
+0 1 7
+0 2 9
+0 5 14
+1 2 10
+1 3 15
+2 3 11
+2 5 2
+3 4 6
+5 4 9
+
+Sample Test Case (query input):
+3
+0 4
+4 0
+1 5
+*/
@@ -1,127 +1,219 @@
+// Find single-source shortest (or, with `--longest`, longest/critical) paths in a weighted DAG.
+//
+// One Kahn topological sort over a CSR DAG detects cycles and yields an order in which every edge is relaxed
+// exactly once. With `--parallel`, vertices are processed one topological layer at a time, each layer split
+// across threads that pull distances along their incoming edges. `--graph <file>` maps a binary graph written by
+// graph_convert, whose vertex IDs are already dense, instead of reading the edges; the source still comes from
+// standard input. `--reorder <order>` renumbers the vertices for locality first (see graph_reorder.hpp); input
+// and output still use the original IDs.
+
 #include <iostream>
-#include <unordered_map>
-#include <unordered_set>
+#include <vector>
 #include <limits>
-#include <queue>
 #include <string>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <tuple>
+#include "graph_file.hpp"
+#include "graph_reorder.hpp"
+#include "parallel.hpp"
 
 using namespace std;
 
-struct pair_hash {
-    template<class T1, class T2>
-    size_t operator()(const pair<T1, T2>& p) const {
-        auto hash1 = hash<T1>{}(p.first);
-        auto hash2 = hash<T2>{}(p.second);
-        return hash1 ^ (hash2 << 1); // Combining the hash values
+// Read the text edge list and relabel its vertex IDs densely in ascending order; `ids` maps each dense index
+// back to the input vertex ID
+csr_graph create_dag(vector<size_t>& ids) {
+    size_t edges_count;
+    cin >> edges_count;
+
+    vector<tuple<size_t, size_t, int>> input(edges_count);
+    for (auto& [source, destination, weight] : input) {
+        cin >> source >> destination >> weight;
+        ids.push_back(source);
+        ids.push_back(destination);
     }
-};
 
-typedef unordered_map<size_t, unordered_set<pair<size_t, int>, pair_hash>> adj_list;
+    sort(ids.begin(), ids.end());
+    ids.erase(unique(ids.begin(), ids.end()), ids.end());
+    auto index_of = [&ids](size_t id) {
+        return (uint32_t) (lower_bound(ids.begin(), ids.end(), id) - ids.begin());
+    };
 
-bool dag_checker_dfs(size_t source, adj_list& dag, unordered_set<size_t>& seen,  unordered_set<size_t>& on_path) {
-    for (auto [destination, _] : dag[source]) {
-        if (on_path.count(destination)) {
-            return false;
-        }
-        if (!seen.count(destination)) {
-            seen.insert(destination);
-            on_path.insert(destination);
-            if (!dag_checker_dfs(destination, dag, seen, on_path)) {
-                return false;
-            }
-        }
+    vector<graph_edge> edges;
+    edges.reserve(edges_count);
+    for (auto& [source, destination, weight] : input) {
+        edges.push_back({ index_of(source), index_of(destination), weight });
     }
-    on_path.erase(source);
-    return true;
+
+    return csr_graph::from_edges(ids.size(), edges, true);
 }
 
-bool check_is_dag(adj_list& dag) {
-    unordered_set<size_t> seen, on_path;
-    for (auto& [source, _] : dag) {
-        if (!seen.count(source)) {
-            seen.insert(source);
-            on_path.insert(source);
-            if (!dag_checker_dfs(source, dag, seen, on_path)) {
-                return false;
-            }
-        }
+// Kahn's algorithm, one layer at a time: layer k holds the vertices whose longest chain of predecessors has
+// k edges. Fills `order` with all vertices layer by layer and returns false if a cycle keeps some out.
+bool topological_layers(const csr_graph& dag, vector<uint32_t>& order, vector<size_t>& layer_offsets) {
+    vector<uint32_t> in_degree(dag.num_vertices, 0);
+    for (uint64_t e = 0; e < dag.num_edges; e++) {
+        in_degree[dag.targets[e]]++;
     }
-    return true;
-}
 
-adj_list create_dag() {
-    adj_list dag;
+    order.clear();
+    for (uint32_t v = 0; v < dag.num_vertices; v++) {
+        if (in_degree[v] == 0) {
+            order.push_back(v);
+        }
+    }
 
-    size_t edges_count;
-    cin >> edges_count;
-    for (size_t i = 0; i < edges_count; i++) {
-        size_t source, destination;
-        int weight;
-        cin >> source >> destination >> weight;
-        dag[source].insert({ destination, weight });
+    layer_offsets = { 0 };
+    for (size_t begin = 0; begin < order.size(); begin = layer_offsets.back()) {
+        size_t end = order.size();
+        layer_offsets.push_back(end);
+        for (size_t i = begin; i < end; i++) {
+            uint32_t u = order[i];
+            for (uint64_t e = dag.offsets[u]; e < dag.offsets[u + 1]; e++) {
+                if (--in_degree[dag.targets[e]] == 0) {
+                    order.push_back(dag.targets[e]);
+                }
+            }
+        }
     }
 
-    return dag;
+    return order.size() == dag.num_vertices;
 }
 
-unordered_map<size_t, int> find_shortest_paths(adj_list& dag, size_t source) {
-    unordered_map<size_t, int> distances;
+// Relax every edge once in topological order, keeping the smaller (or larger, for longest paths) distance
+vector<int> find_paths(const csr_graph& dag, const vector<uint32_t>& order, uint32_t source, bool longest) {
+    const int unreachable = longest ? numeric_limits<int>::min() : numeric_limits<int>::max();
+    vector<int> distances(dag.num_vertices, unreachable);
+    distances[source] = 0;
 
-    // Initialise distances to infinite
-    for (auto& [node, _] : dag) {
-        distances[node] = numeric_limits<int>::max();
+    for (uint32_t u : order) {
+        if (distances[u] == unreachable) {
+            continue;
+        }
+        for (uint64_t i = dag.offsets[u]; i < dag.offsets[u + 1]; i++) {
+            int candidate = distances[u] + dag.weights[i];
+            int& current = distances[dag.targets[i]];
+            if (current == unreachable || (longest ? candidate > current : candidate < current)) {
+                current = candidate;
+            }
+        }
     }
 
-    // Set distance to source node to 0
-    distances[source] = 0;
-
-    queue<size_t> frontier;
-    frontier.push(source);
+    return distances;
+}
 
-    while (!frontier.empty()) {
-        size_t u = frontier.front();
-        frontier.pop();
+// Level-synchronous variant: all predecessors of a layer lie in earlier layers, so every vertex of a layer
+// can pull its final distance from its incoming edges independently of the rest of the layer
+vector<int> find_paths_parallel(csr_graph& dag, const vector<uint32_t>& order, const vector<size_t>& layer_offsets,
+                                uint32_t source, bool longest) {
+    const int unreachable = longest ? numeric_limits<int>::min() : numeric_limits<int>::max();
+    dag.build_transpose();
+    vector<int> distances(dag.num_vertices, unreachable);
+    distances[source] = 0;
 
-        for (auto& [v, w] : dag[u]) {
-            // Check violation of triangle inequality
-            if (distances[v] > distances[u] + w) {
-                distances[v] = distances[u] + w;
-                frontier.push(v);
+    for (size_t layer = 0; layer + 1 < layer_offsets.size(); layer++) {
+        // Layers that fit in a single chunk run inline
+        parallel_for(layer_offsets[layer], layer_offsets[layer + 1], 1024, [&](unsigned, size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                uint32_t v = order[i];
+                if (v == source) {
+                    continue;
+                }
+                int best = unreachable;
+                for (uint64_t e = dag.in_offsets[v]; e < dag.in_offsets[v + 1]; e++) {
+                    int from = distances[dag.in_sources[e]];
+                    if (from == unreachable) {
+                        continue;
+                    }
+                    int candidate = from + dag.in_weights[e];
+                    if (best == unreachable || (longest ? candidate > best : candidate < best)) {
+                        best = candidate;
+                    }
+                }
+                distances[v] = best;
             }
-        }
+        });
     }
 
     return distances;
 }
 
-void show_shortest_paths(size_t source, unordered_map<size_t, int>& distances) {
-    cout << "Shortest distances from source " << source << ":" << endl;
-    for (auto& [node, dist] : distances) {
-        cout << node << ": " << (dist == numeric_limits<int>::max() ? "unreachable" : to_string(dist)) << endl;
+void show_paths(const vector<size_t>& ids, const vertex_order& renaming, size_t source, const vector<int>& distances,
+                bool longest) {
+    const int unreachable = longest ? numeric_limits<int>::min() : numeric_limits<int>::max();
+    cout << (longest ? "Longest" : "Shortest") << " distances from source " << source << ":" << endl;
+    for (size_t v = 0; v < ids.size(); v++) {
+        int distance = distances[renaming.to_new(v)];
+        cout << ids[v] << ": " << (distance == unreachable ? "unreachable" : to_string(distance)) << "\n";
     }
 }
 
-int main() {
-    // Get DAG from standard input
-    adj_list dag = create_dag();
-    if (!check_is_dag(dag)) {
+int main(int argc, char* argv[]) {
+    bool longest = false, parallel = false;
+    const char* graph_file = nullptr;
+    const char* reorder = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--longest") == 0) {
+            longest = true;
+        } else if (strcmp(argv[i], "--parallel") == 0) {
+            parallel = true;
+        } else if (strcmp(argv[i], "--graph") == 0 && i + 1 < argc) {
+            graph_file = argv[++i];
+        } else if (strcmp(argv[i], "--reorder") == 0 && i + 1 < argc) {
+            reorder = argv[++i];
+        } else {
+            cout << "Invalid Arguments." << " Usage: dag_relaxation [--longest] [--parallel] [--graph <file>]"
+                 << " [--reorder <rcm|bfs|degree|hub>]" << endl;
+            return 1;
+        }
+    }
+
+    // Get DAG from the graph file, whose vertex IDs are already dense, or from standard input
+    csr_graph dag;
+    vector<size_t> ids;
+    if (graph_file) {
+        if (!dag.load(graph_file) || !dag.weighted()) {
+            cerr << "Could not load weighted graph from " << graph_file << "." << endl;
+            exit(1);
+        }
+        ids.resize(dag.num_vertices);
+        for (uint32_t v = 0; v < dag.num_vertices; v++) {
+            ids[v] = v;
+        }
+    } else {
+        dag = create_dag(ids);
+    }
+
+    // ids stay indexed by the original dense IDs; renaming maps those to the reordered vertices
+    vertex_order renaming;
+    if (reorder && !reorder_graph(dag, reorder, renaming)) {
+        cerr << "Unknown vertex order " << reorder << "." << endl;
+        exit(1);
+    }
+    vector<uint32_t> order;
+    vector<size_t> layer_offsets;
+    if (!topological_layers(dag, order, layer_offsets)) {
         cerr << "Not a DAG." << endl;
         exit(1);
     }
 
     // Identify source vertex
-    size_t source;
-    cin >> source;
-    if (!dag.count(source)) {
+    size_t source = 0;
+    bool source_read = (bool) (cin >> source);
+    auto it = lower_bound(ids.begin(), ids.end(), source);
+    if (!source_read || it == ids.end() || *it != source) {
         cerr << "Source not in DAG." << endl;
         exit(1);
     }
+    uint32_t source_index = renaming.to_new(it - ids.begin());
 
-    // Calculate shortest paths from source
-    unordered_map<size_t, int> distances = find_shortest_paths(dag, source);
+    // Calculate paths from source
+    vector<int> distances = parallel ? find_paths_parallel(dag, order, layer_offsets, source_index, longest)
+                                     : find_paths(dag, order, source_index, longest);
 
     // Print results to standard output
-    show_shortest_paths(source, distances);
+    show_paths(ids, renaming, source, distances, longest);
 
     return 0;
 }
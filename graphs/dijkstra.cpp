@@ -1,81 +1,472 @@
 // Find single-source shortest paths to all vertices in directional graph with only non-negative edges.
+//
+// After the source, the input may list batches of edge weight changes (a batch count, then per batch an update
+// count followed by "source dest weight" lines). Each batch is repaired incrementally and the results reprinted.
+// With `--graph <file>`, the graph comes from a binary file written by graph_convert and standard input starts
+// at the source. `--stats` reports heap operation counts on standard error. `--reorder <order>` renumbers the
+// vertices for locality first (see graph_reorder.hpp); input and output still use the original IDs.
+//
+// `--table` computes a many-to-many distance table instead: the input after the graph is a source count and
+// source list, then a target count and target list. Sources are searched in parallel, each search stopping
+// once every target is settled. The table is printed one source per row, or with `--matrix <file>` written as
+// a 24 byte header ("DISTTAB1", then the source and target counts as little-endian uint64) followed by the
+// sources x targets little-endian uint32 distances in row-major order, UINT32_MAX meaning no path.
 
 #include <iostream>
 #include <vector>
 #include <queue>
-#include <unordered_map>
 #include <limits>
+#include <tuple>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include "graph_file.hpp"
+#include "graph_reorder.hpp"
+#include "parallel.hpp"
 
 using namespace std;
 
 uint INF = numeric_limits<uint>::max();
 
 struct Vertex {
-    bool explored;
+    bool invalidated;
     uint id, parent_id, dist;
-    unordered_map<uint, uint> out_edges; // { dest, weight }
+};
+
+// Slot of edge (source, dest) among the out-edges of `source`, or the edge count if there is no such edge
+uint64_t find_edge(const csr_graph &graph, uint source_id, uint dest_id) {
+    for (uint64_t slot = graph.offsets[source_id]; slot < graph.offsets[source_id + 1]; slot++) {
+        if (graph.targets[slot] == dest_id) {
+            return slot;
+        }
+    }
+    return graph.num_edges;
+}
+
+// Min-queue of { dist, id } that counts its operations for `--stats`. Each queue counts privately and adds its
+// counts to the totals when destroyed, so queues on different threads never share a counter.
+struct DistanceQueue : priority_queue<pair<uint, uint>, vector<pair<uint, uint>>, greater<pair<uint, uint>>> {
+    static inline atomic<uint64_t> total_pushes{ 0 }, total_pops{ 0 };
+    uint64_t pushes = 0, pops = 0;
+
+    ~DistanceQueue() {
+        total_pushes += pushes;
+        total_pops += pops;
+    }
+
+    void push(const pair<uint, uint> &entry) {
+        pushes++;
+        priority_queue::push(entry);
+    }
+
+    void pop() {
+        pops++;
+        priority_queue::pop();
+    }
 
-    bool operator<(const Vertex &aOther) const {
-        return dist > aOther.dist;
+    void clear() {
+        c.clear();
     }
 };
 
-int main() {
+// Dijkstra's algorithm at O((E + V) log V) from the queued vertices. A vertex is queued again whenever its
+// distance improves, so entries older than its current distance are skipped when popped.
+void settle(const csr_graph &graph, vector<Vertex> &vertices, DistanceQueue &q) {
+    while (!q.empty()) {
+        auto [ dist, id ] = q.top();
+        q.pop();
+        if (dist > vertices[id].dist) {
+            continue;
+        }
+        for (uint64_t slot = graph.offsets[id]; slot < graph.offsets[id + 1]; slot++) {
+            uint dest = graph.targets[slot], weight = graph.weights[slot];
+            if (vertices[dest].dist > dist + weight) {
+                vertices[dest].dist = dist + weight;
+                vertices[dest].parent_id = id;
+                q.push({ vertices[dest].dist, dest });
+            }
+        }
+    }
+}
+
+typedef tuple<uint, uint, uint> WeightUpdate; // { source, dest, new weight }
+
+// Repair distances and parents after a batch of weight changes, touching only the vertices whose shortest
+// paths can change: subtrees hanging off increased tree edges, and whatever decreased edges improve.
+// Both the out-edge and in-edge copy of each changed weight are updated.
+void apply_updates(csr_graph &graph, vector<Vertex> &vertices, const vector<WeightUpdate> &updates) {
+    vector<uint> increased_roots;
+    vector<pair<uint, uint64_t>> decreased; // { source, slot }
+    for (auto &[ source_id, dest_id, weight ] : updates) {
+        uint64_t slot = find_edge(graph, source_id, dest_id);
+        uint old_weight = graph.weights[slot];
+        graph.weights[slot] = weight;
+        for (uint64_t in_slot = graph.in_offsets[dest_id]; in_slot < graph.in_offsets[dest_id + 1]; in_slot++) {
+            if (graph.in_sources[in_slot] == source_id) {
+                graph.in_weights[in_slot] = weight;
+            }
+        }
+
+        if (weight > old_weight && vertices[dest_id].parent_id == source_id && dest_id != source_id) {
+            increased_roots.push_back(dest_id);
+        } else if (weight < old_weight) {
+            decreased.push_back({ source_id, slot });
+        }
+    }
+
+    // Invalidate the shortest-path subtree below every increased tree edge
+    vector<uint> invalidated;
+    for (uint root : increased_roots) {
+        vector<uint> stack = { root };
+        while (!stack.empty()) {
+            Vertex &vertex = vertices[stack.back()];
+            stack.pop_back();
+            if (vertex.invalidated) {
+                continue;
+            }
+            for (uint64_t slot = graph.offsets[vertex.id]; slot < graph.offsets[vertex.id + 1]; slot++) {
+                uint dest = graph.targets[slot];
+                if (vertices[dest].parent_id == vertex.id && !vertices[dest].invalidated) {
+                    stack.push_back(dest);
+                }
+            }
+            vertex.invalidated = true;
+            vertex.dist = INF;
+            vertex.parent_id = INF;
+            invalidated.push_back(vertex.id);
+        }
+    }
+
+    // Seed invalidated vertices from their best still-valid predecessor, and decreased edges from their source
+    DistanceQueue q;
+    for (uint id : invalidated) {
+        for (uint64_t slot = graph.in_offsets[id]; slot < graph.in_offsets[id + 1]; slot++) {
+            uint source = graph.in_sources[slot], weight = graph.in_weights[slot];
+            if (!vertices[source].invalidated && vertices[source].dist != INF && vertices[id].dist > vertices[source].dist + weight) {
+                vertices[id].dist = vertices[source].dist + weight;
+                vertices[id].parent_id = source;
+            }
+        }
+        if (vertices[id].dist != INF) {
+            q.push({ vertices[id].dist, id });
+        }
+    }
+    for (auto &[ source_id, slot ] : decreased) {
+        uint dest_id = graph.targets[slot], weight = graph.weights[slot]; // latest weight if the batch repeats an edge
+        if (!vertices[source_id].invalidated && vertices[source_id].dist != INF && vertices[dest_id].dist > vertices[source_id].dist + weight) {
+            vertices[dest_id].dist = vertices[source_id].dist + weight;
+            vertices[dest_id].parent_id = source_id;
+            q.push({ vertices[dest_id].dist, dest_id });
+        }
+    }
+    for (uint id : invalidated) {
+        vertices[id].invalidated = false;
+    }
+
+    // Dijkstra restricted to the vertices reached from the seeds
+    settle(graph, vertices, q);
+}
+
+void show_shortest_paths(vector<Vertex> &vertices, const vertex_order &order, const string &heading) {
+    cout << heading << endl;
+    for (uint id = 0; id < vertices.size(); id++) {
+        auto &vertex = vertices[order.to_new(id)];
+        cout << "ID: " << id;
+        
+        cout << "\tParent ID: ";
+        vertex.parent_id == INF ? cout << "NONE" : cout << order.to_original(vertex.parent_id);
+
+        cout << "\tDistance: ";
+        vertex.dist == INF ? cout << "INF" : cout << vertex.dist;
+
+        cout << endl;
+    }
+}
+
+// Per-worker search state for the distance table, reused across every source the worker handles so a search
+// only pays for the vertices it touches
+struct TableScratch {
+    vector<uint> dist;
+    vector<uint> touched;
+    DistanceQueue q;
+
+    TableScratch(uint num_vertices) : dist(num_vertices, INF) {}
+};
+
+// Dijkstra from `source_id` that stops as soon as all `target_count` distinct targets are settled, then copies
+// the target distances into `row`
+void search_targets(const csr_graph &graph, const vector<bool> &is_target, uint target_count, const vector<uint> &targets,
+                    uint source_id, TableScratch &scratch, uint *row) {
+    for (uint id : scratch.touched) {
+        scratch.dist[id] = INF;
+    }
+    scratch.touched.clear();
+    scratch.q.clear(); // entries left over when the previous search stopped early
+
+    scratch.dist[source_id] = 0;
+    scratch.touched.push_back(source_id);
+    scratch.q.push({ 0, source_id });
+    uint remaining = target_count;
+    while (!scratch.q.empty() && remaining > 0) {
+        auto [ dist, id ] = scratch.q.top();
+        scratch.q.pop();
+        if (dist > scratch.dist[id]) {
+            continue;
+        }
+        if (is_target[id]) {
+            remaining--;
+        }
+        for (uint64_t slot = graph.offsets[id]; slot < graph.offsets[id + 1]; slot++) {
+            uint dest = graph.targets[slot], weight = graph.weights[slot];
+            if (scratch.dist[dest] > dist + weight) {
+                if (scratch.dist[dest] == INF) {
+                    scratch.touched.push_back(dest);
+                }
+                scratch.dist[dest] = dist + weight;
+                scratch.q.push({ scratch.dist[dest], dest });
+            }
+        }
+    }
+
+    for (size_t column = 0; column < targets.size(); column++) {
+        row[column] = scratch.dist[targets[column]];
+    }
+}
+
+// Fill the sources x targets table with one early-stopping search per source. The graph is shared read-only;
+// workers pull sources from a shared counter and keep their own scratch.
+vector<uint> distance_table(const csr_graph &graph, const vector<uint> &sources, const vector<uint> &targets) {
+    vector<bool> is_target(graph.num_vertices, false);
+    uint target_count = 0;
+    for (uint id : targets) {
+        target_count += !is_target[id];
+        is_target[id] = true;
+    }
+
+    vector<uint> table(sources.size() * targets.size());
+    vector<unique_ptr<TableScratch>> scratch(thread_count());
+    parallel_for(0, sources.size(), 1, [&](unsigned thread_id, size_t first, size_t last) {
+        if (!scratch[thread_id]) {
+            scratch[thread_id] = make_unique<TableScratch>(graph.num_vertices);
+        }
+        for (size_t i = first; i < last; i++) {
+            search_targets(graph, is_target, target_count, targets, sources[i], *scratch[thread_id], &table[i * targets.size()]);
+        }
+    });
+
+    return table;
+}
+
+// Write the table in the binary layout described at the top of this file
+bool write_table(const char *path, const vector<uint> &table, uint64_t num_rows, uint64_t num_columns) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+
+    unsigned char header[24] = { 'D', 'I', 'S', 'T', 'T', 'A', 'B', '1' };
+    for (int i = 0; i < 8; i++) {
+        header[8 + i] = num_rows >> (8 * i);
+        header[16 + i] = num_columns >> (8 * i);
+    }
+    fwrite(header, 1, sizeof(header), file);
+
+    // Encode one row at a time so the output is little-endian whatever the host byte order
+    vector<unsigned char> bytes(num_columns * 4);
+    for (uint64_t row = 0; row < num_rows; row++) {
+        for (uint64_t column = 0; column < num_columns; column++) {
+            uint32_t value = table[row * num_columns + column];
+            for (int byte = 0; byte < 4; byte++) {
+                bytes[column * 4 + byte] = value >> (8 * byte);
+            }
+        }
+        fwrite(bytes.data(), 1, bytes.size(), file);
+    }
+
+    return fclose(file) == 0;
+}
+
+void show_table(const vector<uint> &table, const vector<uint> &sources, const vector<uint> &targets) {
+    string line = "Distance Table:\n";
+    for (size_t row = 0; row < sources.size(); row++) {
+        line += to_string(sources[row]) + ":";
+        for (size_t column = 0; column < targets.size(); column++) {
+            uint dist = table[row * targets.size() + column];
+            line += dist == INF ? " INF" : " " + to_string(dist);
+        }
+        line += "\n";
+        fwrite(line.data(), 1, line.size(), stdout);
+        line.clear();
+    }
+}
+
+// Read a vertex count followed by that many vertex IDs; false if any ID is not in the graph
+bool read_vertex_list(uint num_vertices, vector<uint> &ids) {
+    size_t count;
+    cin >> count;
+    ids.resize(count);
+    for (uint &id : ids) {
+        cin >> id;
+        if (!cin || id >= num_vertices) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Read the graph's edges from standard input; returns false if an edge names a vertex outside the graph
+bool read_graph(csr_graph &graph) {
     uint num_vertices, num_edges;
     cin >> num_vertices >> num_edges;
 
+    vector<graph_edge> edges(num_edges);
+    for (graph_edge &edge : edges) {
+        cin >> edge.source >> edge.dest >> edge.weight;
+        if (edge.source >= num_vertices || edge.dest >= num_vertices) {
+            return false;
+        }
+    }
+
+    graph = csr_graph::from_edges(num_vertices, edges, true);
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    const char *graph_file = nullptr, *matrix_path = nullptr, *reorder = nullptr;
+    bool stats = false, table = false, valid_arguments = true;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--graph") == 0 && i + 1 < argc) {
+            graph_file = argv[++i];
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else if (strcmp(argv[i], "--table") == 0) {
+            table = true;
+        } else if (strcmp(argv[i], "--matrix") == 0 && i + 1 < argc) {
+            matrix_path = argv[++i];
+        } else if (strcmp(argv[i], "--reorder") == 0 && i + 1 < argc) {
+            reorder = argv[++i];
+        } else {
+            valid_arguments = false;
+        }
+    }
+    if (!valid_arguments || (matrix_path && !table)) {
+        cout << "Invalid Arguments." << " Usage: dijkstra [--graph <file>] [--reorder <rcm|bfs|degree|hub>] [--stats]"
+             << " [--table [--matrix <output_file>]]" << endl;
+        return 1;
+    }
+
+    // Map the graph file if one is given; weight updates then copy only the pages they touch
+    csr_graph graph;
+    if (graph_file) {
+        if (!graph.load(graph_file) || !graph.weighted()) {
+            cout << "Could not load weighted graph from " << graph_file << "." << endl;
+            return 1;
+        }
+    } else if (!read_graph(graph)) {
+        cout << "Input vertex not found in graph." << endl;
+        return 1;
+    }
+    uint num_vertices = graph.num_vertices;
+
+    vertex_order order;
+    if (reorder && !reorder_graph(graph, reorder, order)) {
+        cout << "Unknown vertex order " << reorder << "." << endl;
+        return 1;
+    }
+
+    // Many-to-many distance table
+    if (table) {
+        vector<uint> sources, targets;
+        if (!read_vertex_list(num_vertices, sources) || !read_vertex_list(num_vertices, targets)) {
+            cout << "Input vertex not found in graph." << endl;
+            return 1;
+        }
+
+        vector<uint> renamed_sources(sources), renamed_targets(targets);
+        for (uint &id : renamed_sources) {
+            id = order.to_new(id);
+        }
+        for (uint &id : renamed_targets) {
+            id = order.to_new(id);
+        }
+
+        vector<uint> distances = distance_table(graph, renamed_sources, renamed_targets);
+        if (matrix_path) {
+            if (!write_table(matrix_path, distances, sources.size(), targets.size())) {
+                cout << "Could not write distance table to " << matrix_path << endl;
+                return 1;
+            }
+        } else {
+            show_table(distances, sources, targets);
+        }
+
+        if (stats) {
+            cerr << "stats: heap_pushes=" << DistanceQueue::total_pushes << " heap_pops=" << DistanceQueue::total_pops << endl;
+        }
+        return 0;
+    }
+
     // Initialise vertices
     vector<Vertex> vertices(num_vertices);
-    for (int i = 0; i < num_vertices; i++) {
-        vertices[i].explored = false;
+    for (uint i = 0; i < num_vertices; i++) {
+        vertices[i].invalidated = false;
         vertices[i].id = i;
         vertices[i].parent_id = INF;
         vertices[i].dist = INF;
     }
 
-    // Build edges
-    for (int i = 0; i < num_edges; i++) {
-        uint source_id, dest_id, weight;
-        cin >> source_id >> dest_id >> weight;
-        vertices[source_id].out_edges[dest_id] = weight;
-    }
-
     // Get source vertex and set its distance to 0 and parent to itself
     uint source_id;
-    cin >> source_id;
+    if (!(cin >> source_id) || source_id >= num_vertices) {
+        cout << "Input vertex not found in graph." << endl;
+        return 1;
+    }
+    source_id = order.to_new(source_id);
     vertices[source_id].dist = 0;
     vertices[source_id].parent_id = source_id;
 
     // Dijkstra's algorithm at O((E + V) log V)
-    priority_queue<Vertex*> q;
-    q.push(&vertices[source_id]);
-    while (!q.empty()) {
-        Vertex *vertex = q.top();
-        q.pop();
-        if (!vertex->explored) {
-            vertex->explored = true;
-            for (auto &[ dest, weight ] : vertex->out_edges) {
-                if (vertices[dest].dist > vertex->dist + weight) {
-                    vertices[dest].dist = vertex->dist + weight;
-                    vertices[dest].parent_id = vertex->id;
-                    q.push(&vertices[dest]);
-                }
-            }
-        }
+    {
+        DistanceQueue q;
+        q.push({ 0, source_id });
+        settle(graph, vertices, q);
     }
 
     // Print results to standard output
-    cout << "Single-Source Shortest Paths:" << endl;
-    for (auto &vertex : vertices) {
-        cout << "ID: " << vertex.id;
-        
-        cout << "\tParent ID: ";
-        vertex.parent_id == INF ? cout << "NONE" : cout << vertex.parent_id;
+    show_shortest_paths(vertices, order, "Single-Source Shortest Paths:");
 
-        cout << "\tDistance: ";
-        vertex.dist == INF ? cout << "INF" : cout << vertex.dist;
+    // Repair the results after each batch of weight changes instead of recomputing them
+    uint num_batches;
+    if (cin >> num_batches) {
+        graph.build_transpose();
+        for (uint batch = 1; batch <= num_batches; batch++) {
+            uint num_updates;
+            cin >> num_updates;
+            vector<WeightUpdate> updates(num_updates);
+            for (auto &[ source, dest, weight ] : updates) {
+                cin >> source >> dest >> weight;
+                if (source >= num_vertices || dest >= num_vertices) {
+                    cout << "Edge not found in graph." << endl;
+                    return 1;
+                }
+                source = order.to_new(source);
+                dest = order.to_new(dest);
+                if (find_edge(graph, source, dest) == graph.num_edges) {
+                    cout << "Edge not found in graph." << endl;
+                    return 1;
+                }
+            }
 
-        cout << endl;
+            apply_updates(graph, vertices, updates);
+            show_shortest_paths(vertices, order, "Single-Source Shortest Paths after update batch " + to_string(batch) + ":");
+        }
+    }
+
+    if (stats) {
+        cerr << "stats: heap_pushes=" << DistanceQueue::total_pushes << " heap_pops=" << DistanceQueue::total_pops << endl;
     }
 
     return 0;
@@ -0,0 +1,249 @@
+// Benchmark the graph programs in this directory on synthetic graphs of growing size, to find where each one
+// stops scaling.
+//
+// Every algorithm runs on a fitting graph model for each weight range and for vertex counts growing fourfold
+// from `--min-vertices` to `--max-vertices`. Graphs come from graph_generator and are cached in the work
+// directory; programs load them with `--graph`. For each run the table lists wall time, edges per second, peak
+// resident memory and the operation counts the program reports with `--stats`. A run that exceeds `--timeout`
+// is killed and the larger sizes of that algorithm are skipped.
+//
+// The programs are run from `--bin` (compiled under their source names, e.g. bin/dijkstra).
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <chrono>
+#include <algorithm>
+#include <random>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "graph_file.hpp"
+
+using namespace std;
+
+struct BenchmarkCase {
+    string name, program;
+    vector<string> arguments;
+    string model;
+    string input;                   // standard input after the graph: source vertex, query counts, ...
+    uint32_t max_vertices;          // larger sizes are skipped, e.g. for O(V^2) memory
+    bool hierarchy = false;         // the graph's cached contraction hierarchy file is the last argument
+    uint32_t random_queries = 0;    // instead of the graph, the program reads this many random "source dest" pairs
+};
+
+struct RunResult {
+    bool finished = false, succeeded = false;
+    double seconds = 0;
+    long peak_kib = 0;
+    string stats;
+};
+
+const vector<BenchmarkCase> CASES = {
+    { "dijkstra", "dijkstra", { "--stats" }, "road", "0\n", UINT32_MAX },
+    { "dijkstra", "dijkstra", { "--stats" }, "rmat", "0\n", UINT32_MAX },
+    { "dijkstra --reorder rcm", "dijkstra", { "--reorder", "rcm", "--stats" }, "road", "0\n", UINT32_MAX },
+    { "bfs", "bfs", { "--stats" }, "rmat", "0\n", UINT32_MAX },
+    { "bfs", "bfs", { "--stats" }, "road", "0\n", UINT32_MAX },
+    { "bellman_ford", "bellman_ford", { "--stats" }, "grid", "0\n", UINT32_MAX },
+    { "bellman_ford --parallel", "bellman_ford", { "--parallel", "--stats" }, "grid", "0\n", UINT32_MAX },
+    { "bellman_ford", "bellman_ford", { "--stats" }, "negative-cycles", "0\n", UINT32_MAX },
+    { "johnson", "johnson", { "--engine", "johnson", "--matrix", "/dev/null", "--stats" }, "erdos-renyi", "0\n", 16384 },
+    { "floyd_warshall", "johnson", { "--engine", "floyd-warshall", "--matrix", "/dev/null", "--stats" }, "erdos-renyi", "0\n", 4096 },
+    { "kosaraju", "kosaraju", {}, "rmat", "0\n", UINT32_MAX },
+    { "kosaraju --tarjan", "kosaraju", { "--tarjan" }, "rmat", "0\n", UINT32_MAX },
+    { "kosaraju --parallel", "kosaraju", { "--parallel" }, "rmat", "0\n", UINT32_MAX },
+    { "dag_relaxation", "dag_relaxation", {}, "dag", "0\n", UINT32_MAX },
+    { "dag_relaxation --parallel", "dag_relaxation", { "--parallel" }, "dag", "0\n", UINT32_MAX },
+    { "minimum_spanning_tree", "minimum_spanning_tree", {}, "road", "", UINT32_MAX },
+    { "minimum_spanning_tree --boruvka", "minimum_spanning_tree", { "--boruvka" }, "road", "", UINT32_MAX },
+    { "contraction_hierarchies build", "contraction_hierarchies", { "build" }, "road", "", 1 << 20, true },
+    { "contraction_hierarchies query", "contraction_hierarchies", { "query" }, "road", "", 1 << 20, true, 100000 },
+};
+
+// Run `program` with `arguments` and standard input, output and error redirected to the given files; killed
+// after `timeout` seconds
+RunResult run(const string &program, const vector<string> &arguments, const string &input_path,
+              const string &output_path, const string &error_path, double timeout) {
+    RunResult result;
+    auto start = chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        int input = open(input_path.c_str(), O_RDONLY);
+        int output = open(output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        int error = open(error_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        dup2(input, 0);
+        dup2(output, 1);
+        dup2(error, 2);
+        vector<char *> argv = { (char *) program.c_str() };
+        for (const string &argument : arguments) {
+            argv.push_back((char *) argument.c_str());
+        }
+        argv.push_back(nullptr);
+        execv(program.c_str(), argv.data());
+        _exit(127);
+    }
+    if (pid < 0) {
+        return result;
+    }
+
+    int status = 0;
+    struct rusage usage;
+    while (wait4(pid, &status, WNOHANG, &usage) == 0) {
+        if (chrono::duration<double>(chrono::steady_clock::now() - start).count() > timeout) {
+            kill(pid, SIGKILL);
+            wait4(pid, &status, 0, &usage);
+            return result;
+        }
+        usleep(200);
+    }
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    result.finished = true;
+    result.succeeded = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    result.peak_kib = usage.ru_maxrss;
+
+    ifstream error(error_path);
+    string line;
+    while (getline(error, line)) {
+        if (line.rfind("stats: ", 0) == 0) {
+            result.stats = line.substr(7);
+        }
+    }
+    return result;
+}
+
+void write_file(const string &path, const string &contents) {
+    ofstream(path) << contents;
+}
+
+bool file_exists(const string &path) {
+    return access(path.c_str(), F_OK) == 0;
+}
+
+int main(int argc, char *argv[]) {
+    string bin = ".", work = "/tmp";
+    uint32_t min_vertices = 1024, max_vertices = 1 << 20;
+    string degree = "8";
+    vector<string> weight_ranges = { "1:10", "1:10000" };
+    double timeout = 60;
+    bool valid_arguments = true;
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--bin") == 0 && has_value) {
+            bin = argv[++i];
+        } else if (strcmp(argv[i], "--work") == 0 && has_value) {
+            work = argv[++i];
+        } else if (strcmp(argv[i], "--min-vertices") == 0 && has_value) {
+            min_vertices = max(1ul, strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--max-vertices") == 0 && has_value) {
+            max_vertices = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--degree") == 0 && has_value) {
+            degree = argv[++i];
+        } else if (strcmp(argv[i], "--weights") == 0 && has_value) {
+            weight_ranges.clear();
+            stringstream ranges(argv[++i]);
+            for (string range; getline(ranges, range, ',');) {
+                weight_ranges.push_back(range);
+            }
+        } else if (strcmp(argv[i], "--timeout") == 0 && has_value) {
+            timeout = atof(argv[++i]);
+        } else {
+            valid_arguments = false;
+        }
+    }
+    if (!valid_arguments) {
+        cout << "Invalid Arguments. Usage: graph_benchmark [--bin <dir>] [--work <dir>] [--min-vertices n]"
+             << " [--max-vertices n] [--degree d] [--weights min:max,...] [--timeout seconds]" << endl;
+        return 1;
+    }
+
+    string error_path = work + "/graph_benchmark_stderr.txt";
+    printf("%-30s %-16s %10s %11s %-10s %10s %12s %10s  %s\n", "algorithm", "model", "vertices", "edges", "weights",
+           "seconds", "edges/s", "peak MiB", "stats");
+
+    for (const BenchmarkCase &benchmark : CASES) {
+        for (const string &weights : weight_ranges) {
+            for (uint64_t n = min_vertices; n <= min(max_vertices, benchmark.max_vertices); n *= 4) {
+                // Generate (or reuse) the graph for this model, size and weight range
+                string stem = work + "/graph_benchmark_" + benchmark.model + "_" + to_string(n) + "_" + degree + "_" + weights;
+                string graph_path = stem + ".bin";
+                string generator = bin + "/graph_generator";
+                vector<string> generator_arguments = { benchmark.model, to_string(n), "--degree", degree, "--weights", weights };
+                if (!file_exists(graph_path)) {
+                    generator_arguments.push_back(graph_path);
+                    if (!run(generator, generator_arguments, "/dev/null", "/dev/null", error_path, 1e9).succeeded) {
+                        cerr << "Could not generate " << graph_path << "." << endl;
+                        return 1;
+                    }
+                    generator_arguments.pop_back();
+                }
+
+                csr_graph graph;
+                if (!graph.load(graph_path.c_str())) {
+                    cerr << "Could not load " << graph_path << "." << endl;
+                    return 1;
+                }
+
+                // Query benchmarks time the queries alone: the hierarchy is built beforehand if the build
+                // benchmark did not leave one behind
+                string input_path = stem + "_input.txt", hierarchy_path = stem + ".hierarchy";
+                string program = bin + "/" + benchmark.program;
+                vector<string> arguments = benchmark.arguments;
+                RunResult result;
+                bool ready = true;
+                if (benchmark.random_queries > 0) {
+                    mt19937 random(n);
+                    uniform_int_distribution<uint32_t> vertex(0, graph.num_vertices - 1);
+                    ostringstream queries;
+                    queries << benchmark.random_queries << "\n";
+                    for (uint32_t i = 0; i < benchmark.random_queries; i++) {
+                        uint32_t source = vertex(random);
+                        queries << source << " " << vertex(random) << "\n";
+                    }
+                    write_file(input_path, queries.str());
+                    if (benchmark.hierarchy && !file_exists(hierarchy_path)) {
+                        result = run(program, { "build", "--graph", graph_path, hierarchy_path }, "/dev/null",
+                                     "/dev/null", error_path, timeout);
+                        ready = result.succeeded;
+                    }
+                } else {
+                    write_file(input_path, benchmark.input);
+                    arguments.push_back("--graph");
+                    arguments.push_back(graph_path);
+                }
+                if (benchmark.hierarchy) {
+                    arguments.push_back(hierarchy_path);
+                }
+
+                if (ready) {
+                    result = run(program, arguments, input_path, "/dev/null", error_path, timeout);
+                }
+                if (benchmark.hierarchy && !result.succeeded) {
+                    unlink(hierarchy_path.c_str()); // a build killed halfway must not be queried later
+                }
+                printf("%-30s %-16s %10u %11llu %-10s ", benchmark.name.c_str(), benchmark.model.c_str(),
+                       graph.num_vertices, (unsigned long long) graph.num_edges, weights.c_str());
+                if (!result.finished) {
+                    printf("%10s\n", "timeout");
+                    break; // stopped scaling: skip the larger sizes
+                }
+                if (!result.succeeded) {
+                    printf("%10s\n", "failed");
+                    break;
+                }
+                printf("%10.4f %12.0f %10.1f  %s\n", result.seconds, graph.num_edges / result.seconds,
+                       result.peak_kib / 1024.0, result.stats.c_str());
+                fflush(stdout);
+            }
+        }
+    }
+
+    return 0;
+}
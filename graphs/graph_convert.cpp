@@ -0,0 +1,144 @@
+// Convert a graph from the text format read by the programs in this directory into the binary format of
+// graph_file.hpp, which they load with `--graph <file>`.
+//
+// Input on standard input: the vertex count (omitted with `--no-vertex-count`, in which case it is one more
+// than the largest vertex ID), the edge count, then one "source destination weight" line per edge ("source
+// destination" with `--unweighted`). With `--coordinates`, an "x y" line per vertex follows the edges.
+// `--one-based` shifts vertex IDs down by one, as kosaraju numbers its nodes from 1. `--transpose` also stores
+// the in-edges so programs that need them skip building them at startup.
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+#include "graph_file.hpp"
+
+using namespace std;
+
+// Whole-input tokenizer; much faster than extracting one integer at a time from cin
+class Tokenizer {
+public:
+    Tokenizer(FILE* file) {
+        char buffer[1 << 16];
+        size_t count;
+        while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            text.append(buffer, count);
+        }
+        cursor = text.c_str();
+    }
+
+    bool next_integer(long long& value) {
+        char* end;
+        value = strtoll(cursor, &end, 10);
+        if (end == cursor) {
+            return false;
+        }
+        cursor = end;
+        return true;
+    }
+
+    bool next_real(double& value) {
+        char* end;
+        value = strtod(cursor, &end);
+        if (end == cursor) {
+            return false;
+        }
+        cursor = end;
+        return true;
+    }
+
+private:
+    string text;
+    const char* cursor;
+};
+
+int main(int argc, char* argv[]) {
+    bool weighted = true, one_based = false, transpose = false, coordinates = false, vertex_count = true;
+    const char* output = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--unweighted") == 0) {
+            weighted = false;
+        } else if (strcmp(argv[i], "--one-based") == 0) {
+            one_based = true;
+        } else if (strcmp(argv[i], "--transpose") == 0) {
+            transpose = true;
+        } else if (strcmp(argv[i], "--coordinates") == 0) {
+            coordinates = true;
+        } else if (strcmp(argv[i], "--no-vertex-count") == 0) {
+            vertex_count = false;
+        } else if (argv[i][0] != '-' && !output) {
+            output = argv[i];
+        } else {
+            output = nullptr;
+            break;
+        }
+    }
+    if (!output) {
+        cout << "Invalid Arguments. Usage: graph_convert [--unweighted] [--one-based] [--transpose] [--coordinates]"
+             << " [--no-vertex-count] <output_file>" << endl;
+        return 1;
+    }
+
+    Tokenizer input(stdin);
+    long long num_vertices = 0, num_edges;
+    if ((vertex_count && !input.next_integer(num_vertices)) || !input.next_integer(num_edges) || num_edges < 0 ||
+        num_vertices < 0 || num_vertices >= UINT32_MAX) {
+        cerr << "Malformed input: expected vertex and edge counts." << endl;
+        return 1;
+    }
+
+    vector<graph_edge> edges(num_edges);
+    long long largest_id = -1;
+    for (graph_edge& edge : edges) {
+        long long source, dest, weight = 0;
+        if (!input.next_integer(source) || !input.next_integer(dest) || (weighted && !input.next_integer(weight))) {
+            cerr << "Malformed input: expected " << num_edges << " edges." << endl;
+            return 1;
+        }
+        source -= one_based;
+        dest -= one_based;
+        if (source < 0 || dest < 0 || max(source, dest) >= UINT32_MAX - 1) {
+            cerr << "Vertex ID out of range." << endl;
+            return 1;
+        }
+        if (weight < INT32_MIN || weight > INT32_MAX) {
+            cerr << "Edge weight out of range." << endl;
+            return 1;
+        }
+        largest_id = max(largest_id, max(source, dest));
+        edge = { (uint32_t) source, (uint32_t) dest, (int32_t) weight };
+    }
+
+    if (!vertex_count) {
+        num_vertices = largest_id + 1;
+    } else if (largest_id >= num_vertices) {
+        cerr << "Vertex ID out of range." << endl;
+        return 1;
+    }
+
+    csr_graph g = csr_graph::from_edges(num_vertices, edges, weighted);
+    if (transpose) {
+        g.build_transpose();
+    }
+    if (coordinates) {
+        vector<double> xy(2 * num_vertices);
+        for (double& value : xy) {
+            if (!input.next_real(value)) {
+                cerr << "Malformed input: expected " << num_vertices << " coordinate pairs." << endl;
+                return 1;
+            }
+        }
+        g.set_coordinates(move(xy));
+    }
+
+    if (!g.save(output)) {
+        cerr << "Could not write " << output << "." << endl;
+        return 1;
+    }
+    cout << "Wrote " << g.num_vertices << " vertices and " << g.num_edges << " edges to " << output << "." << endl;
+
+    return 0;
+}
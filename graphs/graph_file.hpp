@@ -0,0 +1,412 @@
+// Compressed sparse row graphs shared by the programs in this directory, and a binary file format for them
+// that loads by memory-mapping instead of parsing.
+//
+// File layout (all integers little-endian, every section starting on an 8 byte boundary):
+//   header       magic "GRAPHCSR", uint32 version, uint32 flags, uint64 vertex count, uint64 edge count
+//   offsets      uint64[V + 1]   out-edges of v are [offsets[v], offsets[v + 1])
+//   targets      uint32[E]
+//   weights      int32[E]        if flags & GRAPH_HAS_WEIGHTS
+//   coordinates  double[2V]      x, y per vertex, if flags & GRAPH_HAS_COORDINATES
+//   in_offsets   uint64[V + 1]   transpose, if flags & GRAPH_HAS_TRANSPOSE
+//   in_sources   uint32[E]
+//   in_weights   int32[E]        if the transpose is present and the graph is weighted
+//
+// The file is mapped privately, so several processes share its pages in the page cache and a program that
+// changes weights only copies the pages it writes to.
+
+#ifndef GRAPH_FILE_HPP
+#define GRAPH_FILE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <vector>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const uint32_t GRAPH_FILE_VERSION = 1;
+const uint32_t GRAPH_HAS_WEIGHTS = 1;
+const uint32_t GRAPH_HAS_COORDINATES = 2;
+const uint32_t GRAPH_HAS_TRANSPOSE = 4;
+
+struct graph_file_header {
+    char magic[8];
+    uint32_t version, flags;
+    uint64_t num_vertices, num_edges;
+};
+
+struct graph_edge {
+    uint32_t source, dest;
+    int32_t weight;
+};
+
+// A CSR graph whose arrays live either in a file mapping or in vectors it owns. Unweighted graphs have no
+// weight arrays; the transpose and coordinates are optional.
+class csr_graph {
+public:
+    uint32_t num_vertices = 0;
+    uint64_t num_edges = 0;
+    uint64_t *offsets = nullptr;
+    uint32_t *targets = nullptr;
+    int32_t *weights = nullptr;
+    double *coordinates = nullptr;
+    uint64_t *in_offsets = nullptr;
+    uint32_t *in_sources = nullptr;
+    int32_t *in_weights = nullptr;
+
+    csr_graph() = default;
+    csr_graph(const csr_graph &) = delete;
+    csr_graph &operator=(const csr_graph &) = delete;
+
+    csr_graph(csr_graph &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    csr_graph &operator=(csr_graph &&other) noexcept {
+        if (this != &other) {
+            release();
+            num_vertices = other.num_vertices;
+            num_edges = other.num_edges;
+            offsets = other.offsets;
+            targets = other.targets;
+            weights = other.weights;
+            coordinates = other.coordinates;
+            in_offsets = other.in_offsets;
+            in_sources = other.in_sources;
+            in_weights = other.in_weights;
+            mapping = other.mapping;
+            mapping_size = other.mapping_size;
+            owned_offsets = std::move(other.owned_offsets);
+            owned_targets = std::move(other.owned_targets);
+            owned_weights = std::move(other.owned_weights);
+            owned_coordinates = std::move(other.owned_coordinates);
+            owned_in_offsets = std::move(other.owned_in_offsets);
+            owned_in_sources = std::move(other.owned_in_sources);
+            owned_in_weights = std::move(other.owned_in_weights);
+            other.mapping = nullptr;
+            other.num_vertices = 0;
+            other.num_edges = 0;
+            other.offsets = other.in_offsets = nullptr;
+            other.targets = other.in_sources = nullptr;
+            other.weights = other.in_weights = nullptr;
+            other.coordinates = nullptr;
+        }
+        return *this;
+    }
+
+    ~csr_graph() {
+        release();
+    }
+
+    bool weighted() const {
+        return weights != nullptr;
+    }
+
+    uint64_t out_degree(uint32_t v) const {
+        return offsets[v + 1] - offsets[v];
+    }
+
+    uint64_t in_degree(uint32_t v) const {
+        return in_offsets[v + 1] - in_offsets[v];
+    }
+
+    // Build a CSR graph from an edge list with a counting sort on the source vertex
+    static csr_graph from_edges(uint32_t num_vertices, const std::vector<graph_edge> &edges, bool weighted) {
+        csr_graph g;
+        g.num_vertices = num_vertices;
+        g.num_edges = edges.size();
+        g.owned_offsets.assign((size_t) num_vertices + 1, 0);
+        g.owned_targets.resize(edges.size());
+        if (weighted) {
+            g.owned_weights.resize(edges.size());
+        }
+
+        for (const graph_edge &edge : edges) {
+            g.owned_offsets[edge.source + 1]++;
+        }
+        for (uint32_t v = 0; v < num_vertices; v++) {
+            g.owned_offsets[v + 1] += g.owned_offsets[v];
+        }
+
+        std::vector<uint64_t> next(g.owned_offsets.begin(), g.owned_offsets.end() - 1);
+        for (const graph_edge &edge : edges) {
+            uint64_t slot = next[edge.source]++;
+            g.owned_targets[slot] = edge.dest;
+            if (weighted) {
+                g.owned_weights[slot] = edge.weight;
+            }
+        }
+
+        g.offsets = g.owned_offsets.data();
+        g.targets = g.owned_targets.data();
+        g.weights = weighted ? g.owned_weights.data() : nullptr;
+        return g;
+    }
+
+    // Fill in the transpose (in-edges grouped by destination) unless the file already provided one
+    void build_transpose() {
+        if (in_offsets) {
+            return;
+        }
+
+        owned_in_offsets.assign((size_t) num_vertices + 1, 0);
+        owned_in_sources.resize(num_edges);
+        if (weighted()) {
+            owned_in_weights.resize(num_edges);
+        }
+
+        for (uint64_t e = 0; e < num_edges; e++) {
+            owned_in_offsets[targets[e] + 1]++;
+        }
+        for (uint32_t v = 0; v < num_vertices; v++) {
+            owned_in_offsets[v + 1] += owned_in_offsets[v];
+        }
+
+        std::vector<uint64_t> next(owned_in_offsets.begin(), owned_in_offsets.end() - 1);
+        for (uint32_t u = 0; u < num_vertices; u++) {
+            for (uint64_t e = offsets[u]; e < offsets[u + 1]; e++) {
+                uint64_t slot = next[targets[e]]++;
+                owned_in_sources[slot] = u;
+                if (weighted()) {
+                    owned_in_weights[slot] = weights[e];
+                }
+            }
+        }
+
+        in_offsets = owned_in_offsets.data();
+        in_sources = owned_in_sources.data();
+        in_weights = weighted() ? owned_in_weights.data() : nullptr;
+    }
+
+    // Non-owning graph whose out-edges are this graph's in-edges; valid while this graph lives
+    csr_graph reversed_view() {
+        build_transpose();
+        csr_graph reversed;
+        reversed.num_vertices = num_vertices;
+        reversed.num_edges = num_edges;
+        reversed.offsets = in_offsets;
+        reversed.targets = in_sources;
+        reversed.weights = in_weights;
+        return reversed;
+    }
+
+    // Copy of the graph with vertex v renamed to new_id[v]. Each vertex keeps its out-edges in their original
+    // order; coordinates and the transpose are carried over if present.
+    csr_graph permuted(const std::vector<uint32_t> &new_id) const {
+        std::vector<uint32_t> original(num_vertices);
+        for (uint32_t v = 0; v < num_vertices; v++) {
+            original[new_id[v]] = v;
+        }
+
+        csr_graph g;
+        g.num_vertices = num_vertices;
+        g.num_edges = num_edges;
+        g.owned_offsets.resize((size_t) num_vertices + 1);
+        g.owned_targets.resize(num_edges);
+        if (weighted()) {
+            g.owned_weights.resize(num_edges);
+        }
+
+        g.owned_offsets[0] = 0;
+        for (uint32_t w = 0; w < num_vertices; w++) {
+            uint32_t v = original[w];
+            uint64_t slot = g.owned_offsets[w];
+            for (uint64_t e = offsets[v]; e < offsets[v + 1]; e++, slot++) {
+                g.owned_targets[slot] = new_id[targets[e]];
+                if (weighted()) {
+                    g.owned_weights[slot] = weights[e];
+                }
+            }
+            g.owned_offsets[w + 1] = slot;
+        }
+
+        g.offsets = g.owned_offsets.data();
+        g.targets = g.owned_targets.data();
+        g.weights = weighted() ? g.owned_weights.data() : nullptr;
+        if (coordinates) {
+            std::vector<double> xy(2 * (size_t) num_vertices);
+            for (uint32_t w = 0; w < num_vertices; w++) {
+                xy[2 * w] = coordinates[2 * original[w]];
+                xy[2 * w + 1] = coordinates[2 * original[w] + 1];
+            }
+            g.set_coordinates(std::move(xy));
+        }
+        if (in_offsets) {
+            g.build_transpose();
+        }
+        return g;
+    }
+
+    void set_coordinates(std::vector<double> xy) {
+        owned_coordinates = std::move(xy);
+        coordinates = owned_coordinates.data();
+    }
+
+    // Map a graph file; the arrays point straight into the mapping. Files whose header does not match their
+    // size, or whose offsets or vertex IDs are out of range, are rejected, so the programs can index with them
+    // unchecked. That check reads every offset and target once.
+    bool load(const char *path) {
+        if (!host_is_little_endian()) {
+            return false; // the arrays are used in place, which needs the file's byte order
+        }
+
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) < 0 || (size_t) info.st_size < sizeof(graph_file_header)) {
+            close(fd);
+            return false;
+        }
+        void *data = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+
+        release();
+        mapping = data;
+        mapping_size = info.st_size;
+
+        const graph_file_header *header = (const graph_file_header *) data;
+        if (memcmp(header->magic, "GRAPHCSR", 8) != 0 || header->version != GRAPH_FILE_VERSION ||
+            header->num_vertices >= UINT32_MAX || expected_size(*header) > mapping_size) {
+            release();
+            return false;
+        }
+
+        num_vertices = header->num_vertices;
+        num_edges = header->num_edges;
+        char *cursor = (char *) data + sizeof(graph_file_header);
+        offsets = (uint64_t *) take(cursor, (num_vertices + 1) * sizeof(uint64_t));
+        targets = (uint32_t *) take(cursor, num_edges * sizeof(uint32_t));
+        weights = header->flags & GRAPH_HAS_WEIGHTS ? (int32_t *) take(cursor, num_edges * sizeof(int32_t)) : nullptr;
+        coordinates = header->flags & GRAPH_HAS_COORDINATES ? (double *) take(cursor, 2 * num_vertices * sizeof(double)) : nullptr;
+        if (header->flags & GRAPH_HAS_TRANSPOSE) {
+            in_offsets = (uint64_t *) take(cursor, (num_vertices + 1) * sizeof(uint64_t));
+            in_sources = (uint32_t *) take(cursor, num_edges * sizeof(uint32_t));
+            in_weights = weighted() ? (int32_t *) take(cursor, num_edges * sizeof(int32_t)) : nullptr;
+        }
+        if (!valid_adjacency(offsets, targets, num_vertices, num_edges) ||
+            (in_offsets && !valid_adjacency(in_offsets, in_sources, num_vertices, num_edges))) {
+            release();
+            return false;
+        }
+        return true;
+    }
+
+    // Write the graph (with its transpose and coordinates, if present) in the layout described above
+    bool save(const char *path) const {
+        if (!host_is_little_endian()) {
+            return false;
+        }
+
+        FILE *file = fopen(path, "wb");
+        if (!file) {
+            return false;
+        }
+
+        graph_file_header header;
+        memcpy(header.magic, "GRAPHCSR", 8);
+        header.version = GRAPH_FILE_VERSION;
+        header.flags = (weighted() ? GRAPH_HAS_WEIGHTS : 0) | (coordinates ? GRAPH_HAS_COORDINATES : 0) |
+                       (in_offsets ? GRAPH_HAS_TRANSPOSE : 0);
+        header.num_vertices = num_vertices;
+        header.num_edges = num_edges;
+
+        bool written = put(file, &header, sizeof(header)) && put(file, offsets, (num_vertices + 1) * sizeof(uint64_t)) &&
+                       put(file, targets, num_edges * sizeof(uint32_t));
+        if (written && weighted()) {
+            written = put(file, weights, num_edges * sizeof(int32_t));
+        }
+        if (written && coordinates) {
+            written = put(file, coordinates, 2 * num_vertices * sizeof(double));
+        }
+        if (written && in_offsets) {
+            written = put(file, in_offsets, (num_vertices + 1) * sizeof(uint64_t)) &&
+                      put(file, in_sources, num_edges * sizeof(uint32_t)) &&
+                      (!weighted() || put(file, in_weights, num_edges * sizeof(int32_t)));
+        }
+        // fclose flushes the buffer, so it can fail on a write even when every fwrite succeeded
+        return fclose(file) == 0 && written;
+    }
+
+private:
+    void *mapping = nullptr;
+    size_t mapping_size = 0;
+    std::vector<uint64_t> owned_offsets, owned_in_offsets;
+    std::vector<uint32_t> owned_targets, owned_in_sources;
+    std::vector<int32_t> owned_weights, owned_in_weights;
+    std::vector<double> owned_coordinates;
+
+    static bool host_is_little_endian() {
+        uint16_t probe = 1;
+        return *(const unsigned char *) &probe == 1;
+    }
+
+    static uint64_t padded(uint64_t bytes) {
+        return (bytes + 7) / 8 * 8;
+    }
+
+    // Bytes the sections of a file with this header take, or UINT64_MAX if the counts are too large for any
+    // file; the bound also keeps the sums below from overflowing. The vertex count is checked beforehand.
+    static uint64_t expected_size(const graph_file_header &header) {
+        uint64_t v = header.num_vertices, e = header.num_edges;
+        if (e > UINT64_MAX / 64) {
+            return UINT64_MAX;
+        }
+        bool weighted = header.flags & GRAPH_HAS_WEIGHTS;
+        uint64_t size = sizeof(graph_file_header) + padded((v + 1) * 8) + padded(e * 4) + (weighted ? padded(e * 4) : 0);
+        if (header.flags & GRAPH_HAS_COORDINATES) {
+            size += 16 * v;
+        }
+        if (header.flags & GRAPH_HAS_TRANSPOSE) {
+            size += padded((v + 1) * 8) + padded(e * 4) + (weighted ? padded(e * 4) : 0);
+        }
+        return size;
+    }
+
+    static void *take(char *&cursor, uint64_t bytes) {
+        void *section = cursor;
+        cursor += padded(bytes);
+        return section;
+    }
+
+    // Offsets start at 0, never decrease and end at the edge count, and every target is a vertex
+    static bool valid_adjacency(const uint64_t *offsets, const uint32_t *targets, uint32_t num_vertices, uint64_t num_edges) {
+        if (offsets[0] != 0 || offsets[num_vertices] != num_edges) {
+            return false;
+        }
+        for (uint32_t v = 0; v < num_vertices; v++) {
+            if (offsets[v] > offsets[v + 1]) {
+                return false;
+            }
+        }
+        for (uint64_t e = 0; e < num_edges; e++) {
+            if (targets[e] >= num_vertices) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Write a section and its padding; false on a short write
+    static bool put(FILE *file, const void *data, uint64_t bytes) {
+        static const char zeros[8] = {};
+        uint64_t padding = padded(bytes) - bytes;
+        return fwrite(data, 1, bytes, file) == bytes && fwrite(zeros, 1, padding, file) == padding;
+    }
+
+    void release() {
+        if (mapping) {
+            munmap(mapping, mapping_size);
+            mapping = nullptr;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,355 @@
+// Generate synthetic graphs with controlled parameters for testing and benchmarking the programs in this
+// directory. The graph is written in the binary format of graph_file.hpp (load it with `--graph <file>`), or
+// with `--text` printed to standard output in the "V E" + "source dest weight" text format instead.
+//
+// Models:
+//   erdos-renyi       V vertices, about V * degree directed edges between uniformly random pairs
+//   rmat              R-MAT power-law graph (quadrant probabilities 0.57, 0.19, 0.19, 0.05); V is rounded up to
+//                     a power of two
+//   grid              square 2D grid, every neighbour pair joined in both directions
+//   road              grid with jittered coordinates, some streets missing, a few long fast roads, and weights
+//                     proportional to Euclidean length
+//   geometric         random points in the unit square joined in both directions when closer than the radius
+//                     that gives the requested average degree; weights proportional to length
+//   dag               `--layers` layers, every edge going from a layer to one of the next three
+//   negative-cycles   erdos-renyi with non-negative weights plus `--cycles` planted cycles of `--cycle-length`
+//                     edges whose weights are all negative
+//
+// Self-loops and parallel edges are dropped, so every model produces a simple graph.
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include "graph_file.hpp"
+
+using namespace std;
+
+struct GeneratorOptions {
+    uint32_t num_vertices = 0;
+    double degree = 8;
+    int min_weight = 1, max_weight = 100;
+    uint32_t layers = 0, cycles = 1, cycle_length = 3;
+    uint64_t seed = 1;
+};
+
+class Generator {
+public:
+    Generator(const GeneratorOptions &options) : options(options), random(options.seed) {}
+
+    int random_weight() {
+        return uniform_int_distribution<int>(options.min_weight, options.max_weight)(random);
+    }
+
+    uint32_t random_vertex(uint32_t begin, uint32_t end) {
+        return uniform_int_distribution<uint32_t>(begin, end - 1)(random);
+    }
+
+    // Weight for an edge of Euclidean length `length`, where `unit` is a typical edge length
+    int length_weight(double length, double unit) {
+        double scaled = options.min_weight + (options.max_weight - options.min_weight) * length / (2 * unit);
+        return (int) min<double>(options.max_weight, round(scaled));
+    }
+
+    void erdos_renyi(vector<graph_edge> &edges) {
+        uint32_t n = options.num_vertices;
+        uint64_t m = (uint64_t) (n * options.degree);
+        for (uint64_t i = 0; i < m && n > 1; i++) {
+            edges.push_back({ random_vertex(0, n), random_vertex(0, n), random_weight() });
+        }
+    }
+
+    void rmat(vector<graph_edge> &edges) {
+        uint32_t scale = 0;
+        while ((1ull << scale) < options.num_vertices) {
+            scale++;
+        }
+        options.num_vertices = 1u << scale;
+
+        const double a = 0.57, b = 0.19, c = 0.19;
+        uniform_real_distribution<double> coin(0, 1);
+        uint64_t m = (uint64_t) (options.num_vertices * options.degree);
+        for (uint64_t i = 0; i < m; i++) {
+            uint32_t source = 0, dest = 0;
+            for (uint32_t bit = 0; bit < scale; bit++) {
+                double p = coin(random);
+                source = source << 1 | (p >= a + b);
+                dest = dest << 1 | ((p >= a && p < a + b) || p >= a + b + c);
+            }
+            edges.push_back({ source, dest, random_weight() });
+        }
+    }
+
+    uint32_t grid_side() {
+        uint32_t side = max<uint32_t>(1, (uint32_t) sqrt((double) options.num_vertices));
+        options.num_vertices = side * side;
+        return side;
+    }
+
+    void grid(vector<graph_edge> &edges, vector<double> &coordinates) {
+        uint32_t side = grid_side();
+        coordinates.resize(2 * (size_t) options.num_vertices);
+        for (uint32_t y = 0; y < side; y++) {
+            for (uint32_t x = 0; x < side; x++) {
+                uint32_t v = y * side + x;
+                coordinates[2 * v] = x;
+                coordinates[2 * v + 1] = y;
+                if (x + 1 < side) {
+                    edges.push_back({ v, v + 1, random_weight() });
+                    edges.push_back({ v + 1, v, random_weight() });
+                }
+                if (y + 1 < side) {
+                    edges.push_back({ v, v + side, random_weight() });
+                    edges.push_back({ v + side, v, random_weight() });
+                }
+            }
+        }
+    }
+
+    void road(vector<graph_edge> &edges, vector<double> &coordinates) {
+        uint32_t side = grid_side();
+        uniform_real_distribution<double> jitter(-0.3, 0.3), coin(0, 1);
+        coordinates.resize(2 * (size_t) options.num_vertices);
+        for (uint32_t v = 0; v < options.num_vertices; v++) {
+            coordinates[2 * v] = v % side + jitter(random);
+            coordinates[2 * v + 1] = v / side + jitter(random);
+        }
+
+        auto join = [&](uint32_t u, uint32_t v, double speed) {
+            double length = hypot(coordinates[2 * u] - coordinates[2 * v], coordinates[2 * u + 1] - coordinates[2 * v + 1]);
+            int weight = length_weight(length / speed, 1);
+            edges.push_back({ u, v, weight });
+            edges.push_back({ v, u, weight });
+        };
+
+        for (uint32_t v = 0; v < options.num_vertices; v++) {
+            uint32_t x = v % side, y = v / side;
+            if (x + 1 < side && coin(random) < 0.9) {
+                join(v, v + 1, 1);
+            }
+            if (y + 1 < side && coin(random) < 0.9) {
+                join(v, v + side, 1);
+            }
+            // Roughly one vertex in a hundred starts a highway a few blocks long, three times as fast
+            if (coin(random) < 0.01) {
+                uint32_t reach = random_vertex(2, 9);
+                if (x + reach < side) {
+                    join(v, v + reach, 3);
+                }
+                if (y + reach < side) {
+                    join(v, v + reach * side, 3);
+                }
+            }
+        }
+    }
+
+    void geometric(vector<graph_edge> &edges, vector<double> &coordinates) {
+        uint32_t n = options.num_vertices;
+        double radius = sqrt(options.degree / (M_PI * max<uint32_t>(n, 1)));
+        uniform_real_distribution<double> position(0, 1);
+        coordinates.resize(2 * (size_t) n);
+        for (double &value : coordinates) {
+            value = position(random);
+        }
+
+        // Bucket points into cells of the radius so only neighbouring cells are compared
+        uint32_t cells = max<uint32_t>(1, (uint32_t) min(1 / radius, sqrt((double) n)));
+        auto cell_of = [&](uint32_t v, int axis) {
+            return min<uint32_t>(cells - 1, (uint32_t) (coordinates[2 * v + axis] * cells));
+        };
+        vector<uint32_t> cell_offsets((size_t) cells * cells + 1, 0), members(n);
+        for (uint32_t v = 0; v < n; v++) {
+            cell_offsets[cell_of(v, 1) * cells + cell_of(v, 0) + 1]++;
+        }
+        for (size_t i = 0; i + 1 < cell_offsets.size(); i++) {
+            cell_offsets[i + 1] += cell_offsets[i];
+        }
+        vector<uint32_t> next(cell_offsets.begin(), cell_offsets.end() - 1);
+        for (uint32_t v = 0; v < n; v++) {
+            members[next[cell_of(v, 1) * cells + cell_of(v, 0)]++] = v;
+        }
+
+        for (uint32_t u = 0; u < n; u++) {
+            uint32_t cx = cell_of(u, 0), cy = cell_of(u, 1);
+            for (uint32_t y = cy > 0 ? cy - 1 : 0; y <= min(cells - 1, cy + 1); y++) {
+                for (uint32_t x = cx > 0 ? cx - 1 : 0; x <= min(cells - 1, cx + 1); x++) {
+                    for (uint32_t i = cell_offsets[y * cells + x]; i < cell_offsets[y * cells + x + 1]; i++) {
+                        uint32_t v = members[i];
+                        double length = hypot(coordinates[2 * u] - coordinates[2 * v], coordinates[2 * u + 1] - coordinates[2 * v + 1]);
+                        if (u != v && length <= radius) {
+                            edges.push_back({ u, v, length_weight(length, radius / 2) });
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void dag(vector<graph_edge> &edges) {
+        uint32_t n = options.num_vertices;
+        uint32_t layers = options.layers ? options.layers : max<uint32_t>(1, (uint32_t) sqrt((double) n));
+        layers = min(layers, max<uint32_t>(n, 1));
+        auto layer_begin = [&](uint32_t layer) {
+            return (uint32_t) ((uint64_t) n * layer / layers);
+        };
+
+        for (uint32_t layer = 0; layer + 1 < layers; layer++) {
+            for (uint32_t u = layer_begin(layer); u < layer_begin(layer + 1); u++) {
+                for (uint32_t i = 0; i < (uint32_t) options.degree; i++) {
+                    uint32_t target_layer = random_vertex(layer + 1, min(layers, layer + 4));
+                    if (layer_begin(target_layer) < layer_begin(target_layer + 1)) {
+                        edges.push_back({ u, random_vertex(layer_begin(target_layer), layer_begin(target_layer + 1)), random_weight() });
+                    }
+                }
+            }
+        }
+    }
+
+    // Planted cycles come first so they win over random edges between the same vertices
+    void negative_cycles(vector<graph_edge> &edges) {
+        uint32_t n = options.num_vertices;
+        uint32_t length = min(options.cycle_length, n);
+        for (uint32_t c = 0; c < options.cycles && length >= 2; c++) {
+            vector<uint32_t> cycle;
+            while (cycle.size() < length) {
+                uint32_t v = random_vertex(0, n);
+                if (find(cycle.begin(), cycle.end(), v) == cycle.end()) {
+                    cycle.push_back(v);
+                }
+            }
+            for (uint32_t i = 0; i < length; i++) {
+                edges.push_back({ cycle[i], cycle[(i + 1) % length], -uniform_int_distribution<int>(1, 10)(random) });
+            }
+        }
+
+        options.min_weight = max(options.min_weight, 0);
+        options.max_weight = max(options.max_weight, options.min_weight);
+        erdos_renyi(edges);
+    }
+
+    uint32_t num_vertices() const {
+        return options.num_vertices;
+    }
+
+private:
+    GeneratorOptions options;
+    mt19937_64 random;
+};
+
+// Drop self-loops and parallel edges, keeping the first copy of each (source, dest) pair
+void make_simple(vector<graph_edge> &edges) {
+    edges.erase(remove_if(edges.begin(), edges.end(), [](const graph_edge &edge) {
+        return edge.source == edge.dest;
+    }), edges.end());
+    stable_sort(edges.begin(), edges.end(), [](const graph_edge &a, const graph_edge &b) {
+        return a.source != b.source ? a.source < b.source : a.dest < b.dest;
+    });
+    edges.erase(unique(edges.begin(), edges.end(), [](const graph_edge &a, const graph_edge &b) {
+        return a.source == b.source && a.dest == b.dest;
+    }), edges.end());
+}
+
+void write_text(uint32_t num_vertices, const vector<graph_edge> &edges) {
+    string out = to_string(num_vertices) + " " + to_string(edges.size()) + "\n";
+    for (const graph_edge &edge : edges) {
+        out += to_string(edge.source) + " " + to_string(edge.dest) + " " + to_string(edge.weight) + "\n";
+        if (out.size() >= (1 << 16)) {
+            fwrite(out.data(), 1, out.size(), stdout);
+            out.clear();
+        }
+    }
+    fwrite(out.data(), 1, out.size(), stdout);
+}
+
+int main(int argc, char *argv[]) {
+    GeneratorOptions options;
+    string model;
+    const char *output = nullptr;
+    bool text = false, transpose = false, valid_arguments = argc >= 3;
+    for (int i = 1; i < argc && valid_arguments; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--degree") == 0 && has_value) {
+            options.degree = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--weights") == 0 && has_value) {
+            valid_arguments = sscanf(argv[++i], "%d:%d", &options.min_weight, &options.max_weight) == 2 &&
+                              options.min_weight <= options.max_weight;
+        } else if (strcmp(argv[i], "--layers") == 0 && has_value) {
+            options.layers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cycles") == 0 && has_value) {
+            options.cycles = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cycle-length") == 0 && has_value) {
+            options.cycle_length = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && has_value) {
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--transpose") == 0) {
+            transpose = true;
+        } else if (strcmp(argv[i], "--text") == 0) {
+            text = true;
+        } else if (argv[i][0] == '-') {
+            valid_arguments = false;
+        } else if (model.empty()) {
+            model = argv[i];
+        } else if (options.num_vertices == 0) {
+            options.num_vertices = strtoul(argv[i], nullptr, 10);
+        } else if (!output) {
+            output = argv[i];
+        } else {
+            valid_arguments = false;
+        }
+    }
+    valid_arguments &= options.num_vertices > 0 && options.num_vertices < (1u << 31) && (text || output);
+    if (!valid_arguments) {
+        cout << "Invalid Arguments. Usage: graph_generator <erdos-renyi|rmat|grid|road|geometric|dag|negative-cycles>"
+             << " <vertices> [--degree d] [--weights min:max] [--layers n] [--cycles n] [--cycle-length n]"
+             << " [--seed n] [--transpose] (--text | <output_file>)" << endl;
+        return 1;
+    }
+
+    Generator generator(options);
+    vector<graph_edge> edges;
+    vector<double> coordinates;
+    if (model == "erdos-renyi") {
+        generator.erdos_renyi(edges);
+    } else if (model == "rmat") {
+        generator.rmat(edges);
+    } else if (model == "grid") {
+        generator.grid(edges, coordinates);
+    } else if (model == "road") {
+        generator.road(edges, coordinates);
+    } else if (model == "geometric") {
+        generator.geometric(edges, coordinates);
+    } else if (model == "dag") {
+        generator.dag(edges);
+    } else if (model == "negative-cycles") {
+        generator.negative_cycles(edges);
+    } else {
+        cout << "Unknown model " << model << "." << endl;
+        return 1;
+    }
+    make_simple(edges);
+
+    if (text) {
+        write_text(generator.num_vertices(), edges);
+        return 0;
+    }
+
+    csr_graph graph = csr_graph::from_edges(generator.num_vertices(), edges, true);
+    if (!coordinates.empty()) {
+        graph.set_coordinates(move(coordinates));
+    }
+    if (transpose) {
+        graph.build_transpose();
+    }
+    if (!graph.save(output)) {
+        cerr << "Could not write " << output << "." << endl;
+        return 1;
+    }
+    cout << "Wrote " << graph.num_vertices << " vertices and " << graph.num_edges << " edges to " << output << "." << endl;
+
+    return 0;
+}
@@ -1,203 +1,478 @@
 // Find the shortest path between all vertex pairs in a general simple graph
+//
+// Sparse graphs are solved with Johnson's algorithm, dense graphs with a blocked Floyd-Warshall. The engine is
+// picked from the edge density E / V^2 unless forced with `--engine johnson` or `--engine floyd-warshall`.
+//
+// Distances of all pairs are written as text, or with `--matrix <file>` as a binary matrix instead: a 16 byte
+// header ("APSPMAT1" and the vertex count as a little-endian uint64) followed by V x V little-endian int32
+// distances in row-major order, INT_MAX meaning no path. Paths are only materialised for the pairs listed
+// after the edges (a count followed by "source dest" pairs). `--graph <file>` maps a binary graph written by
+// graph_convert instead of reading the edges, so standard input only holds the path queries. `--stats` reports
+// Dijkstra's heap operation counts on standard error. `--reorder <order>` renumbers the vertices for locality
+// first (see graph_reorder.hpp); input and output still use the original IDs.
 
 #include <iostream>
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 #include <queue>
 #include <limits>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include "graph_file.hpp"
+#include "graph_reorder.hpp"
+#include "parallel.hpp"
 
 using namespace std;
 
 const int INF = numeric_limits<int>::max();
 
-struct Vertex {
-    int id;
-    unordered_map<int, int> outgoing_edges; // { destination id, weight };
-    unordered_map<int, pair<int, int>> shortest_to_me; // { root id, { dist from root, parent id } }
-};
-
-struct Edge {
-    int source_id, dest_id;
-    int weight;
-};
+// Edge density E / V^2 from which Floyd-Warshall's O(V^3) beats Johnson's O(VE log V)
+const double FLOYD_WARSHALL_MIN_DENSITY = 0.1;
 
-// Check if traversing given edge yields shorter path from root to edge's destination
-bool relax_edge(Edge &edge, vector<Vertex> &vertices, int root_id) {
-    if (vertices[edge.source_id].shortest_to_me[root_id].second == INF) {
-        return false; // Can't see path from root vertex to edge's source vertex
-    }
+// Floyd-Warshall tile edge; three int tiles of this size stay resident in L1/L2 cache
+const int TILE_SIZE = 64;
 
-    if (vertices[edge.dest_id].shortest_to_me[root_id].second == INF || vertices[edge.dest_id].shortest_to_me[root_id].first > vertices[edge.source_id].shortest_to_me[root_id].first + edge.weight) {
-        vertices[edge.dest_id].shortest_to_me[root_id] = { vertices[edge.source_id].shortest_to_me[root_id].first + edge.weight, edge.source_id };
-        return true; // Relaxed (found better path)
-    }
+// Calculate SSSP from a virtual vertex with zero-weighted edges to all vertices, storing them as potentials
+bool bellman_ford(const csr_graph &graph, vector<int> &potentials) {
+    // The virtual vertex reaches every vertex at distance 0 before any relaxation
+    fill(potentials.begin(), potentials.end(), 0);
 
-    return false; // Did not relax (original path as good or better)
-}
-
-// Calculate SSSP from newly created vertex with zero-weighted edges to all vertices
-bool bellman_ford(vector<Vertex> &vertices, vector<Edge> &edges, int root_id) {
-    // Relax all edges |V| - 1 times (|V| being number of vertices in the graph)
-    for (int i = 0; i < vertices.size() - 1; i++) {
+    // Relax all edges |V| times (|V| + 1 vertices including the virtual one)
+    for (size_t i = 0; i < potentials.size(); i++) {
         bool did_relax = false;
 
-        for (Edge &edge : edges) {
-            if (relax_edge(edge, vertices, root_id)) {
-                did_relax = true;
+        for (int source = 0; source < (int) graph.num_vertices; source++) {
+            for (size_t e = graph.offsets[source]; e < graph.offsets[source + 1]; e++) {
+                int dest = graph.targets[e];
+                if (potentials[dest] > potentials[source] + graph.weights[e]) {
+                    potentials[dest] = potentials[source] + graph.weights[e];
+                    did_relax = true;
+                }
             }
         }
 
         if (!did_relax) {
-            break;
+            return true; // no negative-weight cycles in graph
         }
     }
 
-    // Run 1 more cycle of edge relaxation to check if negative-weight cycle(s) exist
-    for (Edge &edge : edges) {
-        if (relax_edge(edge, vertices, root_id)) {
-            return false; // simple SSSP doesn't exist for graph
+    // Still relaxing after |V| passes, so a negative-weight cycle exists
+    for (int source = 0; source < (int) graph.num_vertices; source++) {
+        for (size_t e = graph.offsets[source]; e < graph.offsets[source + 1]; e++) {
+            if (potentials[graph.targets[e]] > potentials[source] + graph.weights[e]) {
+                return false; // simple SSSP doesn't exist for graph
+            }
         }
     }
 
-    return true; // no negative-weight cycles in graph
+    return true;
 }
 
-// Calculate SSSP sourced at root_id for transformed graph having only non-negative edges
-void dijkstra(vector<Vertex> &vertices, int root_id) {
-    auto comparator = [root_id](Vertex *source, Vertex *dest) {
-        return source->shortest_to_me[root_id].first > dest->shortest_to_me[root_id].first;
-    };
-
-    unordered_set<int> seen_ids;
-    priority_queue<Vertex *, vector<Vertex *>, decltype(comparator)> q(comparator);
-
-    q.push(&vertices[root_id]);
-
-    while (!q.empty()) {
-        Vertex *vertex = q.top();
-        q.pop();
-        if (!seen_ids.count(vertex->id)) {
-            seen_ids.insert(vertex->id);
-            for (auto &[ dest, weight ] : vertex->outgoing_edges) {
-                if (vertices[dest].shortest_to_me[root_id].first > vertex->shortest_to_me[root_id].first + weight) {
-                    vertices[dest].shortest_to_me[root_id].first = vertex->shortest_to_me[root_id].first + weight;
-                    vertices[dest].shortest_to_me[root_id].second = vertex->id;
-                    q.push(&vertices[dest]);
+// Heap operations over all Dijkstra runs, reported with `--stats`
+atomic<uint64_t> heap_pushes(0), heap_pops(0);
+
+// Per-worker scratch space, reused across every source the worker handles
+struct DijkstraScratch {
+    vector<int> dist;
+    vector<int> touched;
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> q;
+    uint64_t pushes = 0, pops = 0;
+
+    DijkstraScratch(int num_vertices) : dist(num_vertices, INF) {}
+};
+
+// Calculate SSSP sourced at root_id over reweighted (non-negative) edges, writing one row of each matrix
+void dijkstra(const csr_graph &graph, const vector<int> &potentials, int root_id, DijkstraScratch &scratch,
+              int *dist_row, int *parent_row) {
+    for (int id : scratch.touched) {
+        scratch.dist[id] = INF;
+    }
+    scratch.touched.clear();
+
+    scratch.dist[root_id] = 0;
+    scratch.touched.push_back(root_id);
+    parent_row[root_id] = root_id;
+    scratch.q.push({ 0, root_id });
+    scratch.pushes++;
+
+    while (!scratch.q.empty()) {
+        auto [ dist, id ] = scratch.q.top();
+        scratch.q.pop();
+        scratch.pops++;
+        if (dist > scratch.dist[id]) {
+            continue; // stale entry, vertex already settled with a shorter distance
+        }
+
+        for (size_t i = graph.offsets[id]; i < graph.offsets[id + 1]; i++) {
+            int dest = graph.targets[i];
+            int weight = graph.weights[i] + potentials[id] - potentials[dest];
+            if (scratch.dist[dest] > dist + weight) {
+                if (scratch.dist[dest] == INF) {
+                    scratch.touched.push_back(dest);
                 }
+                scratch.dist[dest] = dist + weight;
+                parent_row[dest] = id;
+                scratch.q.push({ scratch.dist[dest], dest });
+                scratch.pushes++;
             }
         }
     }
+
+    // Undo the reweighting to recover path weights under the original edge weights
+    for (int id : scratch.touched) {
+        dist_row[id] = scratch.dist[id] - potentials[root_id] + potentials[id];
+    }
 }
 
-// Recursively recalculate stored path weights using original (non-reweighted) edge weights.
-void recalculate_path_weights(vector<Vertex> &vertices, int root_id, int my_id, int carry) {
-    vertices[my_id].shortest_to_me[root_id].first = carry;
-    for (auto &[ dest, weight ] : vertices[my_id].outgoing_edges) {
-        if (vertices[dest].shortest_to_me[root_id].second == my_id) {
-            recalculate_path_weights(vertices, root_id, dest, carry + weight);
+// Run one Dijkstra per source; sources are independent, so workers pull them one at a time and each reuses
+// its own scratch space across the sources it handles
+void all_pairs_dijkstra(const csr_graph &graph, const vector<int> &potentials, vector<int> &distances, vector<int> &parents) {
+    int num_vertices = graph.num_vertices;
+    vector<unique_ptr<DijkstraScratch>> scratch(thread_count());
+
+    parallel_for(0, num_vertices, 1, [&](unsigned thread_id, size_t first, size_t last) {
+        if (!scratch[thread_id]) {
+            scratch[thread_id] = make_unique<DijkstraScratch>(num_vertices);
+        }
+        for (size_t source = first; source < last; source++) {
+            size_t row = source * num_vertices;
+            dijkstra(graph, potentials, (int) source, *scratch[thread_id], &distances[row], &parents[row]);
+        }
+    });
+
+    for (const unique_ptr<DijkstraScratch> &used : scratch) {
+        if (used) {
+            heap_pushes += used->pushes;
+            heap_pops += used->pops;
         }
     }
 }
 
-// Recursively print vertices on path rooted at `from_id` terminating at `to_id`
-void print_path(vector<Vertex> &vertices, int from_id, int to_id) {
-    if (to_id != from_id) {
-        print_path(vertices, from_id, vertices[to_id].shortest_to_me[from_id].second);
+// Johnson's algorithm to solve APSP in O(VE log V) time
+bool johnson(const csr_graph &graph, vector<int> &distances, vector<int> &parents) {
+    // Use Bellman-Ford to determine vertex potentials that make every edge non-negative and identify if negative-weight cycles exist
+    vector<int> potentials(graph.num_vertices);
+    if (!bellman_ford(graph, potentials)) {
+        return false;
     }
-    cout << " " << to_id;
+
+    // Perform Dijkstra on each vertex using the reweighted edge values
+    all_pairs_dijkstra(graph, potentials, distances, parents);
+    return true;
 }
 
-// Johnson's algorithm to solve APSP in O(VE log V) time
-int main() {
-    int num_vertices, num_edges;
-    cin >> num_vertices >> num_edges;
+// a + b clamped to [INT_MIN, INT_MAX] instead of wrapping, which distances can reach once a negative-weight cycle
+// drives them down before the per-tile cycle check runs. Bit operations only, so the loop using it vectorises.
+inline int saturating_add(int a, int b) {
+    int sum = (int) ((unsigned) a + (unsigned) b);
+    int overflow = ((a ^ sum) & (b ^ sum)) >> 31; // all ones if the sum's sign differs from both operands'
+    int saturated = (a >> 31) ^ INF; // INT_MAX for a >= 0, INT_MIN for a < 0
+    return (sum & ~overflow) | (saturated & overflow);
+}
 
-    // Initialise vertices
-    vector<Vertex> vertices(num_vertices);
-    unordered_map<int, pair<int, int>> shortest_init;
-    for (int i = 0; i < num_vertices; i++) {
-        shortest_init[i] = { INF, INF };
+// Min-plus update of `count` entries of row i through vertex k: D[i][j] = min(D[i][j], D[i][k] + D[k][j]).
+// Every load and store is unconditional and every choice a mask, so with the fixed count of a full tile GCC
+// vectorises the loop at plain -O2 (16 byte SSE2 vectors on x86-64). Rows i and k must differ.
+inline void min_plus_row(int *__restrict dist_i, int *__restrict parent_i, const int *__restrict dist_k,
+                         const int *__restrict parent_k, int dist_ik, int count) {
+    for (int j = 0; j < count; j++) {
+        int through_k = dist_k[j], via = parent_k[j], current = dist_i[j], current_parent = parent_i[j];
+        int unreachable = -(int) (through_k == INF);
+        int candidate = (saturating_add(dist_ik, through_k) & ~unreachable) | (INF & unreachable);
+        int better = -(int) (candidate < current);
+        dist_i[j] = (candidate & better) | (current & ~better);
+        parent_i[j] = (via & better) | (current_parent & ~better);
+    }
+}
+
+// Min-plus update of tile (ib, jb) through the vertices of tile kb
+void update_tile(vector<int> &distances, vector<int> &parents, int num_vertices, int ib, int jb, int kb) {
+    int i_end = min(ib + TILE_SIZE, num_vertices);
+    int j_end = min(jb + TILE_SIZE, num_vertices);
+    int k_end = min(kb + TILE_SIZE, num_vertices);
+
+    for (int k = kb; k < k_end; k++) {
+        const int *dist_k = &distances[(size_t) k * num_vertices + jb];
+        const int *parent_k = &parents[(size_t) k * num_vertices + jb];
+        for (int i = ib; i < i_end; i++) {
+            int dist_ik = distances[(size_t) i * num_vertices + k];
+            // Row k through itself only changes if D[k][k] < 0, a negative cycle the caller reports anyway
+            if (dist_ik == INF || i == k) {
+                continue;
+            }
+            int *dist_i = &distances[(size_t) i * num_vertices + jb];
+            int *parent_i = &parents[(size_t) i * num_vertices + jb];
+            if (j_end - jb == TILE_SIZE) {
+                min_plus_row(dist_i, parent_i, dist_k, parent_k, dist_ik, TILE_SIZE);
+            } else {
+                min_plus_row(dist_i, parent_i, dist_k, parent_k, dist_ik, j_end - jb);
+            }
+        }
     }
+}
+
+// Blocked Floyd-Warshall to solve APSP in O(V^3) time. For each diagonal tile kb: phase 1 closes the diagonal
+// tile, phase 2 updates the tiles sharing its row or column, phase 3 updates every remaining tile. Tiles within
+// phases 2 and 3 are independent and run in parallel.
+bool floyd_warshall(const csr_graph &graph, vector<int> &distances, vector<int> &parents) {
+    int num_vertices = graph.num_vertices;
     for (int i = 0; i < num_vertices; i++) {
-        vertices[i].id = i;
-        vertices[i].shortest_to_me = shortest_init;
-        vertices[i].shortest_to_me[i] = { 0, i };
+        distances[(size_t) i * num_vertices + i] = 0;
+        parents[(size_t) i * num_vertices + i] = i;
+    }
+    for (int source = 0; source < num_vertices; source++) {
+        for (size_t e = graph.offsets[source]; e < graph.offsets[source + 1]; e++) {
+            size_t cell = (size_t) source * num_vertices + graph.targets[e];
+            if (graph.weights[e] < distances[cell]) {
+                distances[cell] = graph.weights[e];
+                parents[cell] = source;
+            }
+        }
+    }
+
+    int num_tiles = (num_vertices + TILE_SIZE - 1) / TILE_SIZE;
+    for (int kt = 0; kt < num_tiles; kt++) {
+        int kb = kt * TILE_SIZE;
+
+        // Phase 1: diagonal tile
+        update_tile(distances, parents, num_vertices, kb, kb, kb);
+
+        // Phase 2: tiles in the same tile row and tile column as the diagonal tile
+        parallel_for(0, 2 * (num_tiles - 1), 1, [&](unsigned, size_t task, size_t) {
+            int other = (int) (task / 2);
+            other = (other >= kt ? other + 1 : other) * TILE_SIZE;
+            if (task % 2 == 0) {
+                update_tile(distances, parents, num_vertices, kb, other, kb);
+            } else {
+                update_tile(distances, parents, num_vertices, other, kb, kb);
+            }
+        });
+
+        // Phase 3: all remaining tiles, which only read the tiles finished in phases 1 and 2
+        parallel_for(0, (size_t) (num_tiles - 1) * (num_tiles - 1), 1, [&](unsigned, size_t task, size_t) {
+            int it = (int) (task / (num_tiles - 1)), jt = (int) (task % (num_tiles - 1));
+            it = it >= kt ? it + 1 : it;
+            jt = jt >= kt ? jt + 1 : jt;
+            update_tile(distances, parents, num_vertices, it * TILE_SIZE, jt * TILE_SIZE, kb);
+        });
+
+        // A negative diagonal entry means a vertex reaches itself through a negative-weight cycle, and shortest
+        // paths are undefined from there on
+        for (int i = 0; i < num_vertices; i++) {
+            if (distances[(size_t) i * num_vertices + i] < 0) {
+                return false;
+            }
+        }
     }
 
-    // Build edges
-    vector<Edge> edges(num_edges);
-    for (int i = 0; i < num_edges; i++) {
-        cin >> edges[i].source_id >> edges[i].dest_id >> edges[i].weight;
-        vertices[edges[i].source_id].outgoing_edges[edges[i].dest_id] = edges[i].weight;
+    return true;
+}
+
+// Walk the parent matrix back from `to_id` to collect the path from `from_id` in O(path length)
+vector<int> extract_path(const vector<int> &parents, int num_vertices, int from_id, int to_id) {
+    vector<int> path = { to_id };
+    const int *parent_row = &parents[(size_t) from_id * num_vertices];
+    for (int id = to_id; id != from_id; id = parent_row[id]) {
+        path.push_back(parent_row[id]);
     }
+    reverse(path.begin(), path.end());
+    return path;
+}
 
-    // Add a new vertex with outgoing edges of 0 weight to all vertices
-    vertices.push_back({});
-    vertices[num_vertices].id = num_vertices;
-    vertices[num_vertices].shortest_to_me = shortest_init;
-    vertices[num_vertices].shortest_to_me[num_vertices] = { 0, num_vertices };
-    for (int i = 0; i < num_vertices; i++) {
-        // Add 0-weighted edge from new vertex to existing vertex
-        vertices[num_vertices].outgoing_edges[i] = 0;
-        Edge e;
-        e.source_id = num_vertices;
-        e.dest_id = i;
-        e.weight = 0;
-        edges.push_back(e);
+// Text writer that fills a large buffer and hands it to stdio in one call, never flushing per line
+class BufferedWriter {
+private:
+    static const size_t CAPACITY = 1 << 16;
+    char buffer[CAPACITY];
+    size_t used = 0;
 
-        // Set shortest known path from new vertex to existing vertex to unknown
-        vertices[i].shortest_to_me[num_vertices] = { INF, INF };
+public:
+    ~BufferedWriter() {
+        flush();
     }
 
-    // Use Bellman-Ford to determine edge reweight values to avoid negative edges and identify if negative-weight cycles exist
-    if (!bellman_ford(vertices, edges, num_vertices)) {
-        cout << "Cannot determine simple shortest paths as graph contains negative-weight cycles." << endl;
-        return 1;
+    void flush() {
+        fwrite(buffer, 1, used, stdout);
+        used = 0;
     }
 
-    // Remove the new vertex and the edges created for the new vertex
-    vertices.pop_back();
-    for (int i = 0; i < num_vertices; i++) {
-        edges.pop_back();
+    void write(const char *text) {
+        for (; *text; text++) {
+            if (used == CAPACITY) {
+                flush();
+            }
+            buffer[used++] = *text;
+        }
     }
 
-    // Reweight edges by adding shortest distance from new vertex to edge source vertex and subtracting shortest distance from new vertex to edge dest
-    for (Edge &edge : edges) {
-        vertices[edge.source_id].outgoing_edges[edge.dest_id] = edge.weight + vertices[edge.source_id].shortest_to_me[num_vertices].first - vertices[edge.dest_id].shortest_to_me[num_vertices].first;
+    void write(long long value) {
+        char digits[24];
+        snprintf(digits, sizeof(digits), "%lld", value);
+        write(digits);
     }
+};
 
-    // Erase shortest distance stored between new vertex and all other vertices
-    for (Vertex &vertex : vertices) {
-        vertex.shortest_to_me.erase(num_vertices);
+// Write the distance matrix in the binary layout described at the top of this file
+bool write_matrix(const char *path, const vector<int> &distances, const vertex_order &order, int num_vertices) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
     }
 
-    // Perform Dijkstra on each vertex using the reweighted edge values
-    for (Vertex &vertex : vertices) {
-        dijkstra(vertices, vertex.id);
+    unsigned char header[16] = { 'A', 'P', 'S', 'P', 'M', 'A', 'T', '1' };
+    for (int i = 0; i < 8; i++) {
+        header[8 + i] = (uint64_t) num_vertices >> (8 * i);
+    }
+    fwrite(header, 1, sizeof(header), file);
+
+    // Encode one row at a time so the output is little-endian whatever the host byte order
+    vector<unsigned char> row((size_t) num_vertices * 4);
+    for (int source = 0; source < num_vertices; source++) {
+        const int *dist_row = &distances[(size_t) order.to_new(source) * num_vertices];
+        for (int i = 0; i < num_vertices; i++) {
+            uint32_t value = dist_row[order.to_new(i)];
+            for (int byte = 0; byte < 4; byte++) {
+                row[(size_t) i * 4 + byte] = value >> (8 * byte);
+            }
+        }
+        fwrite(row.data(), 1, row.size(), file);
+    }
+
+    return fclose(file) == 0;
+}
+
+int main(int argc, char *argv[]) {
+    // Optionally force an engine instead of choosing one from the edge density, and/or write a binary matrix
+    string engine;
+    const char *matrix_path = nullptr, *graph_file = nullptr, *reorder = nullptr;
+    bool valid_arguments = true, stats = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            engine = argv[++i];
+            valid_arguments &= engine == "johnson" || engine == "floyd-warshall";
+        } else if (strcmp(argv[i], "--matrix") == 0 && i + 1 < argc) {
+            matrix_path = argv[++i];
+        } else if (strcmp(argv[i], "--graph") == 0 && i + 1 < argc) {
+            graph_file = argv[++i];
+        } else if (strcmp(argv[i], "--reorder") == 0 && i + 1 < argc) {
+            reorder = argv[++i];
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else {
+            valid_arguments = false;
+        }
+    }
+    if (!valid_arguments) {
+        cout << "Invalid Arguments." << " Usage: johnson [--engine johnson|floyd-warshall] [--matrix <output_file>]"
+             << " [--graph <file>] [--reorder <rcm|bfs|degree|hub>] [--stats]" << endl;
+        return 1;
+    }
+
+    // Map the graph file if one is given, otherwise build the graph from edges on standard input
+    csr_graph graph;
+    if (graph_file) {
+        if (!graph.load(graph_file) || !graph.weighted()) {
+            cout << "Could not load weighted graph from " << graph_file << "." << endl;
+            return 1;
+        }
+    } else {
+        int vertices_count, edges_count;
+        cin >> vertices_count >> edges_count;
+        vector<graph_edge> edges(edges_count);
+        for (graph_edge &edge : edges) {
+            cin >> edge.source >> edge.dest >> edge.weight;
+            if (edge.source >= (uint32_t) vertices_count || edge.dest >= (uint32_t) vertices_count) {
+                cout << "Input vertex not found in graph." << endl;
+                return 1;
+            }
+        }
+        graph = csr_graph::from_edges(vertices_count, edges, true);
+    }
+    int num_vertices = graph.num_vertices;
+    size_t num_edges = graph.num_edges;
+
+    vertex_order order;
+    if (reorder && !reorder_graph(graph, reorder, order)) {
+        cout << "Unknown vertex order " << reorder << "." << endl;
+        return 1;
     }
 
-    // Restore original edge weights
-    for (Edge &edge : edges) {
-        vertices[edge.source_id].outgoing_edges[edge.dest_id] = edge.weight;
+    double density = num_vertices == 0 ? 0 : (double) num_edges / ((double) num_vertices * num_vertices);
+    if (engine.empty()) {
+        engine = density >= FLOYD_WARSHALL_MIN_DENSITY ? "floyd-warshall" : "johnson";
+    }
+    cerr << "APSP engine: " << engine << " (edge density " << density << ")" << endl;
+
+    // Solve into row-major V x V distance and parent matrices
+    vector<int> distances((size_t) num_vertices * num_vertices, INF);
+    vector<int> parents((size_t) num_vertices * num_vertices, INF);
+    bool solved = engine == "johnson" ? johnson(graph, distances, parents) : floyd_warshall(graph, distances, parents);
+    if (stats) {
+        cerr << "stats: heap_pushes=" << heap_pushes << " heap_pops=" << heap_pops << endl;
+    }
+    if (!solved) {
+        cout << "Cannot determine simple shortest paths as graph contains negative-weight cycles." << endl;
+        return 1;
     }
 
-    // Recalculate path distances based on original weights
-    for (Vertex &vertex : vertices) {
-        recalculate_path_weights(vertices, vertex.id, vertex.id, 0);
+    BufferedWriter out;
+    if (matrix_path) {
+        if (!write_matrix(matrix_path, distances, order, num_vertices)) {
+            cout << "Could not write distance matrix to " << matrix_path << endl;
+            return 1;
+        }
+    } else {
+        // Print All-Pairs Shortest Path weights to standard output
+        for (int source = 0; source < num_vertices; source++) {
+            const int *dist_row = &distances[(size_t) order.to_new(source) * num_vertices];
+            for (int destination = 0; destination < num_vertices; destination++) {
+                int dist = dist_row[order.to_new(destination)];
+                out.write("From ");
+                out.write(source);
+                out.write(" to ");
+                out.write(destination);
+                if (dist == INF) {
+                    out.write(":\n\tNo Path\n");
+                } else {
+                    out.write(":\n\tWeight: ");
+                    out.write(dist);
+                    out.write("\n");
+                }
+            }
+        }
     }
 
-    // Print All-Pairs Shortest Paths to standard output
-    for (Vertex &source : vertices) {
-        for (Vertex &destination : vertices) {
-            cout << "From " << source.id << " to " << destination.id << ":" << endl;
-            if (destination.shortest_to_me[source.id].first == INF) {
-                cout << "\tNo Path" << endl;
+    // Materialise paths only for the requested pairs
+    int num_path_queries;
+    if (cin >> num_path_queries) {
+        for (int i = 0; i < num_path_queries; i++) {
+            int source, destination;
+            cin >> source >> destination;
+            if (source < 0 || source >= num_vertices || destination < 0 || destination >= num_vertices) {
+                out.flush();
+                cout << "Input vertex not found in graph." << endl;
+                return 1;
+            }
+
+            out.write("Path from ");
+            out.write(source);
+            out.write(" to ");
+            out.write(destination);
+            out.write(":");
+            int from_id = order.to_new(source), to_id = order.to_new(destination);
+            if (distances[(size_t) from_id * num_vertices + to_id] == INF) {
+                out.write(" No Path");
             } else {
-                cout << "\tWeight: " << destination.shortest_to_me[source.id].first << endl << "\tPath:";
-                print_path(vertices, source.id, destination.id);
-                cout << endl;
+                for (int id : extract_path(parents, num_vertices, from_id, to_id)) {
+                    out.write(" ");
+                    out.write(order.to_original(id));
+                }
             }
+            out.write("\n");
         }
     }
 
@@ -210,6 +485,9 @@ Sample Test Case 1:
 0 1 -1
 1 2 -1
 2 0 2
+2
+0 2
+2 1
 
 Sample Test Case 2:
 8 14
@@ -220,7 +498,7 @@ Sample Test Case 2:
 3 1 -7
 2 3 5
 3 2 -3
-4 5 0 
+4 5 0
 5 4 2
 4 7 1
 7 4 0
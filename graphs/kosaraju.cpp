@@ -1,97 +1,510 @@
+// Find the strongly connected components of a directed graph.
+//
+// Runs Kosaraju's two-pass algorithm by default, or Tarjan's one-pass algorithm (no transposed copy) with
+// `--tarjan`. Both use iterative DFS over a CSR graph and label every node with a component ID.
+// `--parallel` runs a multithreaded decomposition instead: trimming, forward-backward search from a pivot
+// for the giant component, then coloring for what remains.
+//
+// `--graph <file>` maps a binary graph written by graph_convert instead of reading the edges from standard input.
+// `--reorder <order>` renumbers the nodes for locality first (see graph_reorder.hpp); input and output still use
+// the original node numbers, though components may be listed in a different order.
+//
+// After the edges, the input may list reachability queries ("can u reach v"); they are answered in one batch
+// from a bitset transitive closure of the condensation DAG.
+
 #include <iostream>
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
-#include <stack>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include "graph_file.hpp"
+#include "graph_reorder.hpp"
+#include "parallel.hpp"
 
 using namespace std;
 
-typedef unordered_set<size_t> nodeGroup;
-typedef unordered_map<size_t, nodeGroup> graph;
+const uint32_t UNVISITED = numeric_limits<uint32_t>::max();
+
+// indices per chunk of the parallel decomposition; a BFS level with a frontier no larger than this runs
+// inline, so deep levels with tiny frontiers do not pay for thread start-up
+const size_t PARALLEL_CHUNK_SIZE = 1024;
+
+// compressed sparse row graphs come from graph_file.hpp: children of node v are
+// targets[offsets[v]] .. targets[offsets[v + 1] - 1], and nodes are numbered from 0 internally
+csr_graph buildGraph(uint32_t nodeCount, const vector<pair<uint32_t, uint32_t>>& edges) {
+    vector<graph_edge> unweighted;
+    unweighted.reserve(edges.size());
+    for (const auto& [startNode, destNode] : edges) unweighted.push_back({ startNode, destNode, 0 });
+    return csr_graph::from_edges(nodeCount, unweighted, false);
+}
 
-// use stack to get nodes in order of finishing times (descending)
-void stackBuilderDFS(size_t node, graph& G, stack<size_t>& S, nodeGroup& visited) {
-    visited.insert(node);
-    for (const size_t& child : G[node])
-        if (visited.find(child) == visited.end())
-            stackBuilderDFS(child, G, S, visited);
-    S.push(node);
+// use an explicit stack of (node, next edge) frames to append nodes in order of finishing times (ascending)
+void stackBuilderDFS(uint32_t root, const csr_graph& G, vector<uint32_t>& S, vector<bool>& visited) {
+    vector<pair<uint32_t, size_t>> frames = { { root, G.offsets[root] } };
+    visited[root] = true;
+    while (!frames.empty()) {
+        auto& [node, edge] = frames.back();
+        if (edge < G.offsets[node + 1]) {
+            uint32_t child = G.targets[edge++];
+            if (!visited[child]) {
+                visited[child] = true;
+                frames.push_back({ child, G.offsets[child] });
+            }
+        } else {
+            S.push_back(node);
+            frames.pop_back();
+        }
+    }
 }
 
 // traverse all nodes possible using DFS, each traversable node is part of the SCC
-void sccFinderDFS(size_t node, graph& T, nodeGroup& visited, nodeGroup& SCC) {
-    visited.insert(node);
-    SCC.insert(node);
-    for (const size_t& child : T[node])
-        if (visited.find(child) == visited.end())
-            sccFinderDFS(child, T, visited, SCC);
+void sccFinderDFS(uint32_t root, const csr_graph& T, vector<uint32_t>& component, uint32_t componentId) {
+    vector<uint32_t> pending = { root };
+    component[root] = componentId;
+    while (!pending.empty()) {
+        uint32_t node = pending.back();
+        pending.pop_back();
+        for (size_t i = T.offsets[node]; i < T.offsets[node + 1]; i++) {
+            uint32_t child = T.targets[i];
+            if (component[child] == UNVISITED) {
+                component[child] = componentId;
+                pending.push_back(child);
+            }
+        }
+    }
+}
+
+// Kosaraju: label components in topological order of the condensation; returns the component count
+uint32_t kosaraju(csr_graph& G, vector<uint32_t>& component) {
+    vector<uint32_t> S;
+    vector<bool> visited(G.num_vertices, false);
+    S.reserve(G.num_vertices);
+
+    // get nodes in order of finishing times (highest last)
+    for (uint32_t node = 0; node < G.num_vertices; node++)
+        if (!visited[node])
+            stackBuilderDFS(node, G, S, visited);
+
+    // get all strongly connected components
+    csr_graph T = G.reversed_view();
+    uint32_t componentCount = 0;
+    for (auto it = S.rbegin(); it != S.rend(); it++)
+        if (component[*it] == UNVISITED)
+            sccFinderDFS(*it, T, component, componentCount++);
+
+    return componentCount;
+}
+
+// Tarjan: one DFS tracking the lowest discovery index reachable from each subtree; components are
+// labelled in reverse topological order of the condensation. Returns the component count.
+uint32_t tarjan(const csr_graph& G, vector<uint32_t>& component) {
+    vector<uint32_t> index(G.num_vertices, UNVISITED), low(G.num_vertices), sccStack;
+    vector<bool> onStack(G.num_vertices, false);
+    vector<pair<uint32_t, size_t>> frames;
+    uint32_t nextIndex = 0, componentCount = 0;
+
+    auto discover = [&](uint32_t node) {
+        index[node] = low[node] = nextIndex++;
+        sccStack.push_back(node);
+        onStack[node] = true;
+        frames.push_back({ node, G.offsets[node] });
+    };
+
+    for (uint32_t root = 0; root < G.num_vertices; root++) {
+        if (index[root] != UNVISITED) continue;
+        discover(root);
+
+        while (!frames.empty()) {
+            uint32_t node = frames.back().first;
+            size_t& edge = frames.back().second;
+
+            if (edge < G.offsets[node + 1]) {
+                uint32_t child = G.targets[edge++];
+                if (index[child] == UNVISITED) discover(child);
+                else if (onStack[child]) low[node] = min(low[node], index[child]);
+                continue;
+            }
+
+            // all children done: a node that is its own low-link roots a component
+            frames.pop_back();
+            if (low[node] == index[node]) {
+                uint32_t member;
+                do {
+                    member = sccStack.back();
+                    sccStack.pop_back();
+                    onStack[member] = false;
+                    component[member] = componentCount;
+                } while (member != node);
+                componentCount++;
+            }
+            if (!frames.empty()) {
+                uint32_t parent = frames.back().first;
+                low[parent] = min(low[parent], low[node]);
+            }
+        }
+    }
+
+    return componentCount;
+}
+
+// shared state of the parallel decomposition; a node is alive until it is assigned a component
+struct parallelSccState {
+    const csr_graph& G;
+    const csr_graph& T;
+    vector<atomic<uint32_t>> component;
+    vector<uint32_t> alive; // nodes not yet assigned, compacted between phases
+    atomic<uint32_t> componentCount;
+
+    parallelSccState(const csr_graph& G, const csr_graph& T) : G(G), T(T), component(G.num_vertices), componentCount(0) {
+        for (uint32_t node = 0; node < G.num_vertices; node++) {
+            component[node].store(UNVISITED, memory_order_relaxed);
+            alive.push_back(node);
+        }
+    }
+
+    bool isAlive(uint32_t node) const {
+        return component[node].load(memory_order_relaxed) == UNVISITED;
+    }
+
+    void compact() {
+        alive.erase(remove_if(alive.begin(), alive.end(), [this](uint32_t node) { return !isAlive(node); }), alive.end());
+    }
+
+    bool hasAliveNeighbour(const csr_graph& H, uint32_t node) const {
+        for (size_t i = H.offsets[node]; i < H.offsets[node + 1]; i++)
+            if (H.targets[i] != node && isAlive(H.targets[i])) return true;
+        return false;
+    }
+
+    // repeatedly peel off nodes with no live predecessor or no live successor, each its own SCC
+    void trim() {
+        atomic<bool> changed(true);
+        while (changed) {
+            changed = false;
+            parallel_for(0, alive.size(), PARALLEL_CHUNK_SIZE, [&](unsigned, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    uint32_t node = alive[i];
+                    if (!hasAliveNeighbour(G, node) || !hasAliveNeighbour(T, node)) {
+                        component[node].store(componentCount++, memory_order_relaxed);
+                        changed = true;
+                    }
+                }
+            });
+            compact();
+        }
+    }
+
+    // level-synchronous BFS over live nodes, marking everything reachable from `root` in `H`
+    void parallelBFS(const csr_graph& H, uint32_t root, vector<atomic<bool>>& reached) {
+        vector<uint32_t> frontier = { root };
+        reached[root] = true;
+        mutex frontierLock;
+        while (!frontier.empty()) {
+            vector<uint32_t> nextFrontier;
+            parallel_for(0, frontier.size(), PARALLEL_CHUNK_SIZE, [&](unsigned, size_t begin, size_t end) {
+                vector<uint32_t> local;
+                for (size_t i = begin; i < end; i++) {
+                    uint32_t node = frontier[i];
+                    for (size_t e = H.offsets[node]; e < H.offsets[node + 1]; e++) {
+                        uint32_t child = H.targets[e];
+                        if (isAlive(child) && !reached[child].load(memory_order_relaxed) && !reached[child].exchange(true))
+                            local.push_back(child);
+                    }
+                }
+                lock_guard<mutex> guard(frontierLock);
+                nextFrontier.insert(nextFrontier.end(), local.begin(), local.end());
+            });
+            frontier.swap(nextFrontier);
+        }
+    }
+
+    // the SCC of a pivot is everything it reaches both forwards and backwards; pick the pivot most likely
+    // to sit in the giant component
+    void forwardBackward() {
+        if (alive.empty()) return;
+        uint32_t pivot = *max_element(alive.begin(), alive.end(), [this](uint32_t a, uint32_t b) {
+            return (G.offsets[a + 1] - G.offsets[a]) * (T.offsets[a + 1] - T.offsets[a]) <
+                   (G.offsets[b + 1] - G.offsets[b]) * (T.offsets[b + 1] - T.offsets[b]);
+        });
+
+        vector<atomic<bool>> forward(G.num_vertices), backward(G.num_vertices);
+        for (uint32_t node : alive) forward[node] = backward[node] = false;
+        parallelBFS(G, pivot, forward);
+        parallelBFS(T, pivot, backward);
+
+        uint32_t id = componentCount++;
+        parallel_for(0, alive.size(), PARALLEL_CHUNK_SIZE, [&](unsigned, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                if (forward[alive[i]] && backward[alive[i]]) component[alive[i]].store(id, memory_order_relaxed);
+        });
+        compact();
+    }
+
+    // coloring: every node takes the largest node ID that reaches it; each node whose color is its own ID
+    // roots an SCC made of the same-colored nodes that reach back to it
+    void coloring() {
+        vector<atomic<uint32_t>> color(G.num_vertices);
+        vector<atomic<bool>> inScc(G.num_vertices);
+        vector<uint32_t> rootComponent(G.num_vertices);
+
+        while (!alive.empty()) {
+            for (uint32_t node : alive) {
+                color[node].store(node, memory_order_relaxed);
+                inScc[node].store(false, memory_order_relaxed);
+            }
+
+            // push colors forward until they stop changing
+            atomic<bool> changed(true);
+            while (changed) {
+                changed = false;
+                parallel_for(0, alive.size(), PARALLEL_CHUNK_SIZE, [&](unsigned, size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) {
+                        uint32_t node = alive[i], c = color[node].load(memory_order_relaxed);
+                        for (size_t e = G.offsets[node]; e < G.offsets[node + 1]; e++) {
+                            uint32_t child = G.targets[e];
+                            if (!isAlive(child)) continue;
+                            uint32_t current = color[child].load(memory_order_relaxed);
+                            while (current < c && !color[child].compare_exchange_weak(current, c, memory_order_relaxed));
+                            if (current < c) changed = true;
+                        }
+                    }
+                });
+            }
+
+            for (uint32_t node : alive) {
+                if (color[node].load(memory_order_relaxed) == node) {
+                    inScc[node].store(true, memory_order_relaxed);
+                    rootComponent[node] = componentCount++;
+                }
+            }
+
+            // grow each root's SCC backwards within its color: a node joins once a same-colored child has
+            changed = true;
+            while (changed) {
+                changed = false;
+                parallel_for(0, alive.size(), PARALLEL_CHUNK_SIZE, [&](unsigned, size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) {
+                        uint32_t node = alive[i], c = color[node].load(memory_order_relaxed);
+                        if (inScc[node].load(memory_order_relaxed)) continue;
+                        for (size_t e = G.offsets[node]; e < G.offsets[node + 1]; e++) {
+                            uint32_t child = G.targets[e];
+                            if (isAlive(child) && color[child].load(memory_order_relaxed) == c && inScc[child].load(memory_order_relaxed)) {
+                                inScc[node].store(true, memory_order_relaxed);
+                                changed = true;
+                                break;
+                            }
+                        }
+                    }
+                });
+            }
+
+            parallel_for(0, alive.size(), PARALLEL_CHUNK_SIZE, [&](unsigned, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                    if (inScc[alive[i]].load(memory_order_relaxed))
+                        component[alive[i]].store(rootComponent[color[alive[i]].load(memory_order_relaxed)], memory_order_relaxed);
+            });
+            compact();
+            trim();
+        }
+    }
+};
+
+// parallel decomposition: trim trivial SCCs, take out the giant SCC with forward-backward search, trim again,
+// then color what remains. Component IDs come out in no particular order. Returns the component count.
+uint32_t parallelScc(csr_graph& G, vector<uint32_t>& component) {
+    csr_graph T = G.reversed_view();
+    parallelSccState state(G, T);
+
+    state.trim();
+    state.forwardBackward();
+    state.trim();
+    state.coloring();
+
+    for (uint32_t node = 0; node < G.num_vertices; node++) component[node] = state.component[node].load(memory_order_relaxed);
+    return state.componentCount;
+}
+
+// condensation: one node per SCC and one edge per distinct pair of components joined by an edge
+csr_graph buildCondensation(const csr_graph& G, const vector<uint32_t>& component, uint32_t componentCount) {
+    vector<pair<uint32_t, uint32_t>> edges;
+    for (uint32_t node = 0; node < G.num_vertices; node++)
+        for (size_t i = G.offsets[node]; i < G.offsets[node + 1]; i++)
+            if (component[node] != component[G.targets[i]])
+                edges.push_back({ component[node], component[G.targets[i]] });
+    sort(edges.begin(), edges.end());
+    edges.erase(unique(edges.begin(), edges.end()), edges.end());
+    return buildGraph(componentCount, edges);
 }
 
-// transpose graph (change direction of all edges)
-graph transposeGraph(graph& G) {
-    graph T;
+// Kahn's algorithm: position of every node in a topological order of the DAG
+vector<uint32_t> topologicalPositions(const csr_graph& dag) {
+    vector<uint32_t> inDegree(dag.num_vertices, 0), order, position(dag.num_vertices);
+    for (uint64_t e = 0; e < dag.num_edges; e++) inDegree[dag.targets[e]]++;
+    for (uint32_t node = 0; node < dag.num_vertices; node++)
+        if (inDegree[node] == 0) order.push_back(node);
+    for (size_t i = 0; i < order.size(); i++) {
+        position[order[i]] = i;
+        for (size_t e = dag.offsets[order[i]]; e < dag.offsets[order[i] + 1]; e++)
+            if (--inDegree[dag.targets[e]] == 0) order.push_back(dag.targets[e]);
+    }
+    return position;
+}
+
+// Answer `can u reach v` for a batch of (source component, target component) queries with a word-parallel
+// bitset transitive closure of the condensation. Targets are split into chunks of consecutive topological
+// positions; a chunk's closure rows are built by OR-ing successor rows in reverse topological order, and
+// only components positioned before the chunk's end can reach into it. Chunks no query asks about are skipped.
+vector<bool> answerReachability(const csr_graph& dag, const vector<pair<uint32_t, uint32_t>>& queries) {
+    const size_t memoryBudget = size_t(256) << 20; // bytes of closure rows held at once
+    uint32_t count = dag.num_vertices;
+    vector<bool> answers(queries.size(), false);
+    if (count == 0) return answers;
+
+    vector<uint32_t> position = topologicalPositions(dag), byPosition(count);
+    for (uint32_t c = 0; c < count; c++) byPosition[position[c]] = c;
+
+    size_t words = max<size_t>(1, min<size_t>((count + 63) / 64, memoryBudget / (size_t(count) * 8)));
+    size_t chunkWidth = words * 64;
+
+    // bucket the queries that need a closure lookup by the chunk holding their target
+    vector<vector<size_t>> byChunk((count + chunkWidth - 1) / chunkWidth);
+    for (size_t q = 0; q < queries.size(); q++) {
+        auto [source, target] = queries[q];
+        if (source == target) answers[q] = true;
+        else if (position[source] < position[target]) byChunk[position[target] / chunkWidth].push_back(q);
+    }
 
-    for (const pair<size_t, nodeGroup>& routes : G)
-        for (const size_t& destNode : routes.second)
-            T[destNode].insert(routes.first);
+    vector<uint64_t> rows;
+    for (size_t chunk = 0; chunk < byChunk.size(); chunk++) {
+        if (byChunk[chunk].empty()) continue;
+        size_t low = chunk * chunkWidth, high = min<size_t>(count, low + chunkWidth);
+        rows.assign(high * words, 0);
 
-    return T;
+        for (size_t p = high; p-- > 0;) {
+            uint64_t* row = &rows[p * words];
+            if (p >= low) row[(p - low) / 64] |= uint64_t(1) << ((p - low) % 64);
+            uint32_t c = byPosition[p];
+            for (size_t e = dag.offsets[c]; e < dag.offsets[c + 1]; e++) {
+                size_t successor = position[dag.targets[e]];
+                if (successor >= high) continue;
+                const uint64_t* reached = &rows[successor * words];
+                for (size_t w = 0; w < words; w++) row[w] |= reached[w];
+            }
+        }
+
+        for (size_t q : byChunk[chunk]) {
+            size_t bit = position[queries[q].second] - low;
+            answers[q] = rows[position[queries[q].first] * words + bit / 64] >> (bit % 64) & 1;
+        }
+    }
+
+    return answers;
 }
 
 // generate graph from standard input
-graph getGraph() {
-    graph G;
+csr_graph getGraph() {
+    uint32_t nodeCount;
     size_t n;
 
     cout << "Enter number of nodes: " << endl;
-    cin >> n;
-
-    for (size_t i = 1; i <= n; i++) G[i] = {};
+    cin >> nodeCount;
 
     cout << "Enter number of (directed) routes: ";
     cin >> n;
 
     cout << "Enter " << n << " paths in format: {startNodeIndex} {destinationNodeIndex}" << endl;
+    vector<pair<uint32_t, uint32_t>> edges;
+    edges.reserve(n);
     while (n--) {
-        size_t startNode, destNode;
+        uint32_t startNode, destNode;
         cin >> startNode >> destNode;
-        G[startNode].insert(destNode);
+        if (startNode < 1 || startNode > nodeCount || destNode < 1 || destNode > nodeCount) {
+            cerr << "Node not in graph." << endl;
+            exit(1);
+        }
+        edges.push_back({ startNode - 1, destNode - 1 }); // nodes are numbered from 1 in the input
     }
 
-    return G;
+    return buildGraph(nodeCount, edges);
 }
 
-int main() {
-    graph G, T;
-    stack<size_t> S;
-    nodeGroup visited;
-    vector<nodeGroup> stronglyConnectedComponents;
+int main(int argc, char* argv[]) {
+    bool useTarjan = false, useParallel = false, validArguments = true;
+    const char* graphFile = nullptr;
+    const char* reorder = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tarjan") == 0 && !useParallel) useTarjan = true;
+        else if (strcmp(argv[i], "--parallel") == 0 && !useTarjan) useParallel = true;
+        else if (strcmp(argv[i], "--graph") == 0 && i + 1 < argc) graphFile = argv[++i];
+        else if (strcmp(argv[i], "--reorder") == 0 && i + 1 < argc) reorder = argv[++i];
+        else validArguments = false;
+    }
+    if (!validArguments) {
+        cout << "Invalid Arguments." << " Usage: kosaraju [--tarjan | --parallel] [--graph <file>]"
+             << " [--reorder <rcm|bfs|degree|hub>]" << endl;
+        return 1;
+    }
 
-    G = getGraph();
-    T = transposeGraph(G);
+    // a graph file (converted with --one-based) is mapped instead of reading the edges from standard input
+    csr_graph G;
+    if (graphFile) {
+        if (!G.load(graphFile)) {
+            cerr << "Could not load graph from " << graphFile << "." << endl;
+            exit(1);
+        }
+    } else {
+        G = getGraph();
+    }
 
-    // get nodes in order of finishing times (highest first)
-    for (const pair<size_t, nodeGroup>& routes : G)
-        if (visited.find(routes.first) == visited.end())
-            stackBuilderDFS(routes.first, G, S, visited);
+    vertex_order order;
+    if (reorder && !reorder_graph(G, reorder, order)) {
+        cerr << "Unknown vertex order " << reorder << "." << endl;
+        exit(1);
+    }
 
-    visited.clear();
+    vector<uint32_t> component(G.num_vertices, UNVISITED);
+    uint32_t componentCount = useParallel ? parallelScc(G, component) : useTarjan ? tarjan(G, component) : kosaraju(G, component);
 
-    // get all strongly connected components
-    while (!S.empty()) {
-        nodeGroup SCC;
-        size_t node = S.top();
-        S.pop();
-        if (visited.find(node) == visited.end()) {
-            sccFinderDFS(node, T, visited, SCC);
-            stronglyConnectedComponents.push_back(SCC);
-        }
-    }
+    // report components by original node numbers: componentOf[node] is the component of the original node
+    vector<uint32_t> componentOf(G.num_vertices);
+    for (uint32_t node = 0; node < G.num_vertices; node++) componentOf[node] = component[order.to_new(node)];
+
+    // group nodes by component ID with a counting sort
+    vector<size_t> start(componentCount + 1, 0);
+    vector<uint32_t> members(G.num_vertices);
+    for (uint32_t node = 0; node < G.num_vertices; node++) start[componentOf[node] + 1]++;
+    for (uint32_t c = 0; c < componentCount; c++) start[c + 1] += start[c];
+    vector<size_t> next(start.begin(), start.end() - 1);
+    for (uint32_t node = 0; node < G.num_vertices; node++) members[next[componentOf[node]]++] = node;
 
     // print all strongly connected components to standard output
-    for (const nodeGroup& scc : stronglyConnectedComponents) {
-        for (const size_t& node : scc) cout << node << " ";
-        cout << endl;
+    for (uint32_t c = 0; c < componentCount; c++) {
+        for (size_t i = start[c]; i < start[c + 1]; i++) cout << members[i] + 1 << " ";
+        cout << "\n";
+    }
+
+    // answer reachability queries through the condensation of the SCCs
+    size_t queryCount;
+    cout << "Enter number of reachability queries: " << endl;
+    if (cin >> queryCount) {
+        cout << "Enter " << queryCount << " queries in format: {startNodeIndex} {destinationNodeIndex}" << endl;
+        vector<pair<uint32_t, uint32_t>> queries(queryCount), componentQueries(queryCount);
+        for (size_t q = 0; q < queryCount; q++) {
+            cin >> queries[q].first >> queries[q].second;
+            if (queries[q].first < 1 || queries[q].first > G.num_vertices || queries[q].second < 1 || queries[q].second > G.num_vertices) {
+                cerr << "Node not in graph." << endl;
+                exit(1);
+            }
+            componentQueries[q] = { componentOf[queries[q].first - 1], componentOf[queries[q].second - 1] };
+        }
+
+        vector<bool> answers = answerReachability(buildCondensation(G, component, componentCount), componentQueries);
+        for (size_t q = 0; q < queryCount; q++)
+            cout << queries[q].first << (answers[q] ? " can reach " : " cannot reach ") << queries[q].second << "\n";
     }
 
     return 0;
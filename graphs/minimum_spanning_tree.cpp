@@ -0,0 +1,343 @@
+// Find a minimum spanning forest of an undirected weighted graph and print its total weight and edges.
+//
+// The default engine is filter-Kruskal: edges are split around a sampled pivot weight, the light half is solved
+// first, and heavy edges whose endpoints are already connected are filtered out before they are ever sorted.
+// Small subproblems are sorted with a parallel merge sort and scanned with Kruskal's algorithm. `--boruvka`
+// runs a multithreaded Boruvka instead: every round all threads find each component's lightest outgoing edge
+// concurrently, then the components are merged along those edges.
+//
+// Input is "V E" followed by E "u v weight" lines, each undirected edge listed once, or with `--graph <file>` a
+// binary graph written by graph_convert or graph_generator, whose arcs are all taken as undirected edges (so
+// both directions of a symmetric graph just add redundant copies). `--reorder <order>` renumbers the vertices
+// for locality first (see graph_reorder.hpp); edges are still printed with the original IDs.
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include "graph_file.hpp"
+#include "graph_reorder.hpp"
+#include "parallel.hpp"
+#include "../data_structures/disjoint_set.hpp"
+
+using namespace std;
+
+struct WeightedEdge {
+    int weight;
+    uint32_t u, v;
+};
+
+bool lighter(const WeightedEdge &a, const WeightedEdge &b) {
+    return a.weight < b.weight;
+}
+
+// Subproblems up to this many edges are sorted outright instead of partitioned further
+const size_t FILTER_KRUSKAL_BASE_SIZE = 1 << 16;
+
+// Ranges shorter than this are not worth spreading across threads
+const size_t PARALLEL_MIN_SIZE = 1 << 15;
+
+// Indices per block when [0, count) is split into one contiguous block per thread
+size_t block_size(size_t count) {
+    unsigned num_blocks = count < PARALLEL_MIN_SIZE ? 1 : thread_count();
+    return max<size_t>(1, (count + num_blocks - 1) / num_blocks);
+}
+
+// Split [0, count) into one contiguous block per thread and run `task(block, begin, end)` on each; blocks are
+// numbered in order from 0 and there are at most thread_count() of them
+template<typename Task>
+void parallel_blocks(size_t count, Task task) {
+    size_t size = block_size(count);
+    parallel_for(0, count, size, [&](unsigned, size_t from, size_t to) {
+        task((unsigned) (from / size), from, to);
+    });
+}
+
+// Sort one block per thread, then merge neighbouring runs pairwise (each round's merges in parallel) through
+// a buffer
+void parallel_sort(WeightedEdge *begin, WeightedEdge *end) {
+    size_t count = end - begin, size = block_size(count);
+    size_t num_runs = (count + size - 1) / size;
+    if (num_runs <= 1) {
+        sort(begin, end, lighter);
+        return;
+    }
+
+    parallel_blocks(count, [&](unsigned, size_t from, size_t to) {
+        sort(begin + from, begin + to, lighter);
+    });
+
+    vector<WeightedEdge> buffer(count);
+    WeightedEdge *source = begin, *target = buffer.data();
+    for (size_t width = 1; width < num_runs; width *= 2) {
+        parallel_for(0, (num_runs + 2 * width - 1) / (2 * width), 1, [&](unsigned, size_t merge_id, size_t) {
+            size_t from = merge_id * 2 * width * size;
+            size_t middle = min(count, from + width * size), to = min(count, from + 2 * width * size);
+            merge(source + from, source + middle, source + middle, source + to, target + from, lighter);
+        });
+        swap(source, target);
+    }
+    if (source != begin) {
+        copy(source, source + count, begin);
+    }
+}
+
+// Keep the edges of [begin, end) that `keep` accepts, in parallel: every thread compacts its block in place,
+// then the blocks are moved together. Returns the new end.
+template<typename Keep>
+WeightedEdge *parallel_filter(WeightedEdge *begin, WeightedEdge *end, Keep keep) {
+    size_t count = end - begin;
+    vector<size_t> block_begin(thread_count()), kept(thread_count(), 0);
+    parallel_blocks(count, [&](unsigned block, size_t from, size_t to) {
+        block_begin[block] = from;
+        kept[block] = stable_partition(begin + from, begin + to, keep) - (begin + from);
+    });
+
+    // std::move needs `out` outside the block, so a block that is already in place is only skipped over
+    WeightedEdge *out = begin;
+    for (size_t t = 0; t < kept.size(); t++) {
+        if (out == begin + block_begin[t]) {
+            out += kept[t];
+        } else if (kept[t] > 0) {
+            out = move(begin + block_begin[t], begin + block_begin[t] + kept[t], out);
+        }
+    }
+    return out;
+}
+
+class SpanningForest {
+public:
+    vector<WeightedEdge> edges;
+    long long total_weight = 0;
+
+    SpanningForest(uint32_t num_vertices) : num_vertices(num_vertices), components(num_vertices), sets(num_vertices) {}
+
+    uint32_t component_count() const {
+        return components;
+    }
+
+    // Filter-Kruskal over [begin, end); edges are permuted in place
+    void filter_kruskal(WeightedEdge *begin, WeightedEdge *end) {
+        while (end - begin > 0 && components > 1) {
+            if ((size_t) (end - begin) <= FILTER_KRUSKAL_BASE_SIZE) {
+                kruskal(begin, end);
+                return;
+            }
+
+            // Pivot on the median weight of a small evenly spaced sample
+            vector<int> sample;
+            for (size_t i = 0; i < 63; i++) {
+                sample.push_back(begin[(end - begin) * i / 63].weight);
+            }
+            nth_element(sample.begin(), sample.begin() + 31, sample.end());
+            int pivot = sample[31];
+
+            WeightedEdge *middle = partition(begin, end, [pivot](const WeightedEdge &edge) {
+                return edge.weight <= pivot;
+            });
+            if (middle == end) {
+                // Every weight is at most the pivot (e.g. all equal), so partitioning cannot make progress
+                kruskal(begin, end);
+                return;
+            }
+
+            // Solve the light edges, then continue with the heavy edges that still join two trees
+            filter_kruskal(begin, middle);
+            end = parallel_filter(middle, end, [this](const WeightedEdge &edge) {
+                return sets.find(edge.u) != sets.find(edge.v);
+            });
+            begin = middle;
+        }
+    }
+
+    // Sort [begin, end) and add every edge that joins two different trees
+    void kruskal(WeightedEdge *begin, WeightedEdge *end) {
+        parallel_sort(begin, end);
+        for (WeightedEdge *edge = begin; edge != end && components > 1; edge++) {
+            add_if_joins(*edge);
+        }
+    }
+
+    // Boruvka rounds until no component has an outgoing edge. Component labels are read-only during a round,
+    // so threads find the lightest edge leaving every component with an atomic min on a packed
+    // (weight, edge index) key; the index breaks ties so that equal weights cannot close a cycle.
+    void boruvka(vector<WeightedEdge> &all_edges) {
+        vector<uint32_t> label(num_vertices);
+        for (uint32_t v = 0; v < num_vertices; v++) {
+            label[v] = v;
+        }
+        vector<atomic<uint64_t>> lightest(num_vertices);
+        const uint64_t NO_EDGE = numeric_limits<uint64_t>::max();
+
+        WeightedEdge *begin = all_edges.data(), *end = begin + all_edges.size();
+        while (end != begin && components > 1) {
+            // Edges inside a component can never be chosen again
+            end = parallel_filter(begin, end, [&label](const WeightedEdge &edge) {
+                return label[edge.u] != label[edge.v];
+            });
+            size_t count = end - begin;
+
+            parallel_blocks(num_vertices, [&](unsigned, size_t from, size_t to) {
+                for (size_t v = from; v < to; v++) {
+                    lightest[v].store(NO_EDGE, memory_order_relaxed);
+                }
+            });
+
+            parallel_blocks(count, [&](unsigned, size_t from, size_t to) {
+                for (size_t i = from; i < to; i++) {
+                    uint64_t key = (uint64_t) ((uint32_t) begin[i].weight ^ 0x80000000u) << 32 | i;
+                    for (uint32_t component : { label[begin[i].u], label[begin[i].v] }) {
+                        uint64_t current = lightest[component].load(memory_order_relaxed);
+                        while (key < current && !lightest[component].compare_exchange_weak(current, key, memory_order_relaxed));
+                    }
+                }
+            });
+
+            bool merged = false;
+            for (uint32_t component = 0; component < num_vertices; component++) {
+                uint64_t key = lightest[component].load(memory_order_relaxed);
+                if (key != NO_EDGE) {
+                    merged |= add_if_joins(begin[(uint32_t) key]);
+                }
+            }
+            if (!merged) {
+                break;
+            }
+
+            // Relabel every vertex with its new component root; finds do not write, so this is safe in parallel
+            parallel_blocks(num_vertices, [&](unsigned, size_t from, size_t to) {
+                for (size_t v = from; v < to; v++) {
+                    label[v] = sets.find((uint32_t) v);
+                }
+            });
+        }
+    }
+
+private:
+    uint32_t num_vertices, components;
+    BasicDisjointSet<uint32_t> sets; // indexed by the graph's uint32_t vertex IDs, which may exceed INT_MAX
+
+    bool add_if_joins(const WeightedEdge &edge) {
+        if (!sets.join(edge.u, edge.v)) {
+            return false;
+        }
+        edges.push_back(edge);
+        total_weight += edge.weight;
+        components--;
+        return true;
+    }
+};
+
+// Read "V E" and E "u v weight" lines from standard input; false if a vertex is out of range
+bool read_edges(uint32_t &num_vertices, vector<WeightedEdge> &edges) {
+    size_t num_edges;
+    cin >> num_vertices >> num_edges;
+    edges.resize(num_edges);
+    for (WeightedEdge &edge : edges) {
+        cin >> edge.u >> edge.v >> edge.weight;
+        if (!cin || edge.u >= num_vertices || edge.v >= num_vertices) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    const char *graph_file = nullptr, *reorder = nullptr;
+    bool use_boruvka = false, valid_arguments = true;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--boruvka") == 0) {
+            use_boruvka = true;
+        } else if (strcmp(argv[i], "--graph") == 0 && i + 1 < argc) {
+            graph_file = argv[++i];
+        } else if (strcmp(argv[i], "--reorder") == 0 && i + 1 < argc) {
+            reorder = argv[++i];
+        } else {
+            valid_arguments = false;
+        }
+    }
+    if (!valid_arguments) {
+        cout << "Invalid Arguments." << " Usage: minimum_spanning_tree [--boruvka] [--graph <file>]"
+             << " [--reorder <rcm|bfs|degree|hub>]" << endl;
+        return 1;
+    }
+
+    uint32_t num_vertices;
+    vector<WeightedEdge> edges;
+    vertex_order order;
+    bool known_order = true;
+    if (graph_file) {
+        csr_graph graph;
+        if (!graph.load(graph_file) || !graph.weighted()) {
+            cout << "Could not load weighted graph from " << graph_file << "." << endl;
+            return 1;
+        }
+        num_vertices = graph.num_vertices;
+        known_order = !reorder || compute_vertex_order(graph, reorder, order);
+        edges.reserve(graph.num_edges);
+        for (uint32_t u = 0; u < num_vertices; u++) {
+            for (uint64_t e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+                edges.push_back({ graph.weights[e], u, graph.targets[e] });
+            }
+        }
+    } else if (!read_edges(num_vertices, edges)) {
+        cout << "Input vertex not found in graph." << endl;
+        return 1;
+    } else if (reorder) {
+        vector<graph_edge> arcs;
+        arcs.reserve(edges.size());
+        for (const WeightedEdge &edge : edges) {
+            arcs.push_back({ edge.u, edge.v, edge.weight });
+        }
+        known_order = compute_vertex_order(csr_graph::from_edges(num_vertices, arcs, false), reorder, order);
+    }
+    if (!known_order) {
+        cout << "Unknown vertex order " << reorder << "." << endl;
+        return 1;
+    }
+
+    // Union-find touches both endpoints of every edge, so renumbered vertices keep its arrays in cache
+    if (reorder) {
+        for (WeightedEdge &edge : edges) {
+            edge.u = order.to_new(edge.u);
+            edge.v = order.to_new(edge.v);
+        }
+    }
+
+    // Self-loops never join two trees
+    edges.erase(remove_if(edges.begin(), edges.end(), [](const WeightedEdge &edge) {
+        return edge.u == edge.v;
+    }), edges.end());
+    if (use_boruvka && edges.size() > numeric_limits<uint32_t>::max()) {
+        cout << "Too many edges for --boruvka." << endl;
+        return 1;
+    }
+
+    SpanningForest forest(num_vertices);
+    if (use_boruvka) {
+        forest.boruvka(edges);
+    } else {
+        forest.filter_kruskal(edges.data(), edges.data() + edges.size());
+    }
+
+    // Print results to standard output
+    string out = "Total weight: " + to_string(forest.total_weight) + "\n" +
+                 "Components: " + to_string(forest.component_count()) + "\n" +
+                 "Edges: " + to_string(forest.edges.size()) + "\n";
+    for (const WeightedEdge &edge : forest.edges) {
+        out += to_string(order.to_original(edge.u)) + " " + to_string(order.to_original(edge.v)) + " " +
+               to_string(edge.weight) + "\n";
+        if (out.size() >= (1 << 16)) {
+            fwrite(out.data(), 1, out.size(), stdout);
+            out.clear();
+        }
+    }
+    fwrite(out.data(), 1, out.size(), stdout);
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+// The thread pool shared by the programs in this directory: a range split into chunks that one worker per
+// core pulls from a shared counter, so workers that finish early take over the rest of the range.
+//
+// Threads are started for every call and joined before it returns. That costs tens of microseconds, so
+// callers pick a chunk size that keeps small ranges (a BFS level with a handful of vertices, a short layer of
+// a DAG) in a single chunk.
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Number of workers parallel_for runs on at most: one per core
+inline unsigned thread_count() {
+    static const unsigned count = std::max(1u, std::thread::hardware_concurrency());
+    return count;
+}
+
+// Run `task(thread_id, from, to)` over chunks of at most `chunk_size` indices covering [begin, end), on up to
+// thread_count() workers including the calling thread, and wait for all of them. Thread IDs are below
+// thread_count() and a worker handles its chunks one after another, so per-thread state indexed by thread_id
+// needs no locking. Never starts more workers than there are chunks; with one chunk, or one core, the chunks
+// run inline on the calling thread.
+template<typename Task>
+void parallel_for(size_t begin, size_t end, size_t chunk_size, Task task) {
+    if (begin >= end) {
+        return;
+    }
+    size_t num_chunks = (end - begin + chunk_size - 1) / chunk_size;
+    unsigned num_threads = (unsigned) std::min<size_t>(thread_count(), num_chunks);
+    if (num_threads == 1) {
+        for (size_t chunk = begin; chunk < end; chunk += chunk_size) {
+            task(0u, chunk, std::min(end, chunk + chunk_size));
+        }
+        return;
+    }
+
+    std::atomic<size_t> next_chunk(begin);
+    auto worker = [&](unsigned thread_id) {
+        for (size_t chunk = next_chunk.fetch_add(chunk_size); chunk < end; chunk = next_chunk.fetch_add(chunk_size)) {
+            task(thread_id, chunk, std::min(end, chunk + chunk_size));
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < num_threads; i++) {
+        pool.emplace_back(worker, i);
+    }
+    worker(0);
+    for (std::thread &t : pool) {
+        t.join();
+    }
+}
+
+#endif